@@ -0,0 +1,576 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if __has_include(<boost/lockfree/queue.hpp>)
+#include <boost/lockfree/queue.hpp>
+#define ZEUS_BENCH_BOOST 1
+#endif
+
+#if __has_include(<rigtorp/MPMCQueue.h>)
+#include <rigtorp/MPMCQueue.h>
+#define ZEUS_BENCH_RIGTORP 1
+#endif
+
+#include "zeus/huge_page_allocator.hpp"
+#include "zeus/queue.hpp"
+#include "zeus/sharded_queue.hpp"
+#include "zeus/spsc_queue.hpp"
+#include "zeus/topology.hpp"
+
+// Benchmarks for zeus queues, built on Google Benchmark. Results can be
+// exported with --benchmark_format=json --benchmark_out=<file>.
+//
+// Environment variables:
+//   ZEUS_BENCH_CPUS      comma-separated CPU list; benchmark thread i is pinned
+//                        to entry i modulo the list length (Linux only)
+//   ZEUS_BENCH_CAPACITY  queue capacity used by every benchmark (default 1024)
+//   ZEUS_BENCH_LANES     lanes of zeus::sharded_queue, which split the
+//                        capacity evenly (default 8)
+//   ZEUS_BENCH_PAYLOADS  comma-separated payload sizes in bytes, chosen among
+//                        bench_payload_sizes (default 8,256)
+//
+// The placement/ benchmarks ignore ZEUS_BENCH_CPUS and pin their producer and
+// consumer to CPUs of the same or of different NUMA nodes, as detected from
+// sysfs, with the queue bound to each node in turn.
+
+namespace {
+/// Payload of a fixed number of bytes, used to compare small and large T.
+template <std::size_t Size>
+struct payload {
+  payload() noexcept = default;
+  explicit payload(std::uint64_t v) noexcept { bytes[0] = v; }
+
+  std::array<std::uint64_t, (Size + 7) / 8> bytes{};
+};
+
+using small_payload = payload<8>;
+
+/// Payload sizes the throughput benchmarks are compiled for. Payloads are
+/// types, so ZEUS_BENCH_PAYLOADS can only select among these at runtime.
+using bench_payload_sizes = std::index_sequence<8, 64, 256, 1024, 4096>;
+
+/// Parses the comma-separated list of integers in the environment variable
+/// name. Returns an empty list if it is not set.
+std::vector<long long> env_list(const char* name) {
+  std::vector<long long> result;
+  if (const char* list = std::getenv(name)) {
+    std::string entry;
+    for (const char* c = list;; ++c) {
+      if (*c == ',' || *c == '\0') {
+        if (!entry.empty()) {
+          result.push_back(std::stoll(entry));
+          entry.clear();
+        }
+        if (*c == '\0') {
+          break;
+        }
+      } else {
+        entry.push_back(*c);
+      }
+    }
+  }
+  return result;
+}
+
+/// Returns the CPUs benchmark threads are pinned to, parsed once from
+/// ZEUS_BENCH_CPUS.
+const std::vector<int>& pinned_cpus() {
+  static const std::vector<int> cpus = [] {
+    const auto list = env_list("ZEUS_BENCH_CPUS");
+    return std::vector<int>(list.begin(), list.end());
+  }();
+  return cpus;
+}
+
+/// Returns true if the payload size was selected through
+/// ZEUS_BENCH_PAYLOADS.
+bool payload_selected(std::size_t size) {
+  static const std::vector<long long> sizes = [] {
+    auto list = env_list("ZEUS_BENCH_PAYLOADS");
+    return list.empty() ? std::vector<long long>{8, 256} : list;
+  }();
+  return std::find(sizes.begin(), sizes.end(),
+                   static_cast<long long>(size)) != sizes.end();
+}
+
+/// Pins the calling thread to the given CPU.
+void pin_to_cpu(int cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpu;
+#endif
+}
+
+/// Pins the calling thread to the CPU configured for benchmark thread i.
+void pin_thread(std::size_t i) {
+  const auto& cpus = pinned_cpus();
+  if (!cpus.empty()) {
+    pin_to_cpu(cpus[i % cpus.size()]);
+  }
+}
+
+/// Returns the queue capacity configured through ZEUS_BENCH_CAPACITY.
+std::size_t bench_capacity() {
+  static const std::size_t capacity = [] {
+    const char* value = std::getenv("ZEUS_BENCH_CAPACITY");
+    return value ? static_cast<std::size_t>(std::stoull(value)) : 1024;
+  }();
+  return capacity;
+}
+
+/// Adapts zeus::queue to the interface used by the benchmarks.
+template <typename T, typename Traits = zeus::queue_traits>
+struct zeus_adapter {
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = true;
+
+  explicit zeus_adapter(std::size_t capacity) : queue(capacity) {}
+
+  void push(const T& value) { queue.push(value); }
+  bool try_push(const T& value) { return queue.try_push(value); }
+  T pop() { return queue.pop(); }
+  std::optional<T> try_pop() { return queue.try_pop(); }
+
+  zeus::queue<T, zeus::dynamic_capacity, Traits> queue;
+};
+
+/// Returns the number of sharded_queue lanes configured through
+/// ZEUS_BENCH_LANES.
+std::size_t bench_lanes() {
+  static const std::size_t lanes = [] {
+    const char* value = std::getenv("ZEUS_BENCH_LANES");
+    return value ? static_cast<std::size_t>(std::stoull(value)) : 8;
+  }();
+  return lanes;
+}
+
+/// Adapts zeus::sharded_queue to the interface used by the benchmarks.
+template <typename T>
+struct sharded_adapter {
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = true;
+
+  explicit sharded_adapter(std::size_t capacity)
+      : queue(bench_lanes(),
+              std::max<std::size_t>(capacity / bench_lanes(), 1)) {}
+
+  void push(const T& value) { queue.push(value); }
+  bool try_push(const T& value) { return queue.try_push(value); }
+  T pop() { return queue.pop(); }
+  std::optional<T> try_pop() { return queue.try_pop(); }
+
+  zeus::sharded_queue<T> queue;
+};
+
+/// Adapts zeus::spsc_queue to the interface used by the benchmarks.
+template <typename T>
+struct spsc_adapter {
+  static constexpr bool multi_producer = false;
+  static constexpr bool multi_consumer = false;
+
+  explicit spsc_adapter(std::size_t capacity) : queue(capacity) {}
+
+  void push(const T& value) { queue.push(value); }
+  bool try_push(const T& value) { return queue.try_push(value); }
+  T pop() { return queue.pop(); }
+  std::optional<T> try_pop() { return queue.try_pop(); }
+
+  zeus::spsc_queue<T> queue;
+};
+
+#if defined(ZEUS_BENCH_BOOST)
+/// Adapts boost::lockfree::queue, spinning in the blocking operations.
+template <typename T>
+struct boost_adapter {
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = true;
+
+  explicit boost_adapter(std::size_t capacity) : queue(capacity) {}
+
+  void push(const T& value) {
+    while (!queue.bounded_push(value)) {
+    }
+  }
+  bool try_push(const T& value) { return queue.bounded_push(value); }
+  T pop() {
+    T value;
+    while (!queue.pop(value)) {
+    }
+    return value;
+  }
+  std::optional<T> try_pop() {
+    T value;
+    return queue.pop(value) ? std::optional<T>(value) : std::nullopt;
+  }
+
+  boost::lockfree::queue<T> queue;
+};
+#endif
+
+#if defined(ZEUS_BENCH_RIGTORP)
+/// Adapts rigtorp::MPMCQueue.
+template <typename T>
+struct rigtorp_adapter {
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = true;
+
+  explicit rigtorp_adapter(std::size_t capacity) : queue(capacity) {}
+
+  void push(const T& value) { queue.push(value); }
+  bool try_push(const T& value) { return queue.try_push(value); }
+  T pop() {
+    T value;
+    queue.pop(value);
+    return value;
+  }
+  std::optional<T> try_pop() {
+    T value;
+    return queue.try_pop(value) ? std::optional<T>(value) : std::nullopt;
+  }
+
+  rigtorp::MPMCQueue<T> queue;
+};
+#endif
+
+/// Producer/consumer split of the benchmark threads.
+enum class topology { one_to_one, many_to_one, one_to_many, many_to_many };
+
+/// Returns the number of producers among threads for the given topology.
+constexpr int producer_count(topology t, int threads) {
+  switch (t) {
+    case topology::one_to_one:
+    case topology::one_to_many:
+      return 1;
+    case topology::many_to_one:
+      return threads - 1;
+    case topology::many_to_many:
+      return threads / 2;
+  }
+  return 1;
+}
+
+/// Queue shared by the threads of a running benchmark. Thread 0 creates it
+/// before the timed loop and destroys it after; the loop boundaries act as
+/// barriers for the other threads.
+template <typename Q>
+std::unique_ptr<Q> shared_queue;
+
+/// Measures blocking push/pop throughput. Each producer pushes one item per
+/// consumer and each consumer pops one item per producer every iteration, so
+/// both sides move the same number of items and no thread is left blocked.
+/// A single thread pushes and pops its own item, measuring the uncontended
+/// path.
+template <typename Q, typename T, topology Topology>
+void BM_Blocking(benchmark::State& state) {
+  const int threads = state.threads();
+  const int producers = producer_count(Topology, threads);
+  const int consumers = threads - producers;
+  const bool producer = state.thread_index() < producers;
+  const int moved = threads == 1 ? 1 : producer ? consumers : producers;
+
+  pin_thread(static_cast<std::size_t>(state.thread_index()));
+  if (state.thread_index() == 0) {
+    shared_queue<Q> = std::make_unique<Q>(bench_capacity());
+  }
+
+  const T item(1);
+  for (auto _ : state) {
+    if (threads == 1) {
+      shared_queue<Q>->push(item);
+      benchmark::DoNotOptimize(shared_queue<Q>->pop());
+    } else if (producer) {
+      for (int i = 0; i < consumers; ++i) {
+        shared_queue<Q>->push(item);
+      }
+    } else {
+      for (int i = 0; i < producers; ++i) {
+        benchmark::DoNotOptimize(shared_queue<Q>->pop());
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * moved);
+  state.counters[producer ? "pushed" : "popped"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * moved),
+      benchmark::Counter::kIsRate);
+
+  if (state.thread_index() == 0) {
+    shared_queue<Q>.reset();
+  }
+}
+
+/// Measures try_push/try_pop throughput. Every attempt counts as an
+/// iteration, and only successful operations count as processed items. A
+/// single thread tries a push and a pop per iteration, counting the pops.
+template <typename Q, typename T, topology Topology>
+void BM_Try(benchmark::State& state) {
+  const int threads = state.threads();
+  const int producers = producer_count(Topology, threads);
+  const bool producer = state.thread_index() < producers;
+
+  pin_thread(static_cast<std::size_t>(state.thread_index()));
+  if (state.thread_index() == 0) {
+    shared_queue<Q> = std::make_unique<Q>(bench_capacity());
+  }
+
+  const T item(1);
+  std::int64_t succeeded = 0;
+  for (auto _ : state) {
+    if (threads == 1) {
+      shared_queue<Q>->try_push(item);
+      succeeded += shared_queue<Q>->try_pop().has_value();
+    } else if (producer) {
+      succeeded += shared_queue<Q>->try_push(item);
+    } else {
+      succeeded += shared_queue<Q>->try_pop().has_value();
+    }
+  }
+
+  state.SetItemsProcessed(succeeded);
+  state.counters["success_ratio"] = benchmark::Counter(
+      static_cast<double>(succeeded) /
+      static_cast<double>(std::max<std::int64_t>(state.iterations(), 1)),
+      benchmark::Counter::kAvgThreads);
+
+  if (state.thread_index() == 0) {
+    shared_queue<Q>.reset();
+  }
+}
+
+/// Measures the round-trip latency of an item bounced between two threads
+/// through a pair of queues, reporting percentiles as counters in
+/// nanoseconds.
+template <typename Q, typename T>
+void BM_RoundTrip(benchmark::State& state) {
+  Q ping(bench_capacity());
+  Q pong(bench_capacity());
+  std::atomic_bool running = true;
+
+  std::thread echo([&] {
+    pin_thread(1);
+    while (running.load(std::memory_order_relaxed)) {
+      if (auto value = ping.try_pop()) {
+        pong.push(*value);
+      }
+    }
+  });
+
+  pin_thread(0);
+  std::vector<std::int64_t> samples;
+  samples.reserve(static_cast<std::size_t>(state.max_iterations));
+
+  const T item(1);
+  for (auto _ : state) {
+    const auto start = std::chrono::steady_clock::now();
+    ping.push(item);
+    benchmark::DoNotOptimize(pong.pop());
+    const auto stop = std::chrono::steady_clock::now();
+    samples.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+            .count());
+  }
+
+  running.store(false, std::memory_order_relaxed);
+  echo.join();
+
+  std::sort(samples.begin(), samples.end());
+  const auto percentile = [&](double p) {
+    if (samples.empty()) {
+      return 0.0;
+    }
+    const auto rank = static_cast<std::size_t>(
+        p * static_cast<double>(samples.size() - 1));
+    return static_cast<double>(samples[rank]);
+  };
+  state.counters["p50_ns"] = percentile(0.50);
+  state.counters["p99_ns"] = percentile(0.99);
+  state.counters["p99.9_ns"] = percentile(0.999);
+}
+
+/// Slot array mapped through zeus::huge_page_allocator, so that it can be
+/// bound to a NUMA node.
+struct placed_traits : zeus::queue_traits {
+  template <typename U>
+  using allocator = zeus::huge_page_allocator<U>;
+};
+
+/// Measures blocking 1P1C throughput with the producer and consumer pinned to
+/// the given CPUs and the queue, both control block and slots, bound to
+/// ring_node.
+void BM_Placement(benchmark::State& state,
+                  int producer_cpu,
+                  int consumer_cpu,
+                  int ring_node) {
+  using placed_queue =
+      zeus::queue<small_payload, zeus::dynamic_capacity, placed_traits>;
+  constexpr int batch = 64;
+
+  zeus::huge_page_options options;
+  options.page_size = 0;
+  options.numa_node = ring_node;
+  auto queue = zeus::make_placed<placed_queue>(
+      options, bench_capacity(), placed_queue::allocator_type(options));
+
+  // Items carry 1 and the final item 0, which stops the consumer
+  std::thread consumer([&] {
+    pin_to_cpu(consumer_cpu);
+    while (queue->pop().bytes[0] != 0) {
+    }
+  });
+
+#if defined(__linux__)
+  cpu_set_t previous;
+  pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous);
+#endif
+  pin_to_cpu(producer_cpu);
+
+  const small_payload item(1);
+  for (auto _ : state) {
+    for (int i = 0; i < batch; ++i) {
+      queue->push(item);
+    }
+  }
+  queue->push(small_payload(0));
+  consumer.join();
+
+#if defined(__linux__)
+  pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+#endif
+  state.SetItemsProcessed(state.iterations() * batch);
+}
+
+/// Registers the placement benchmarks: the producer runs on the first CPU of
+/// the first NUMA node, the consumer on another CPU of the same node or on the
+/// second node, and the queue is bound to each of those nodes.
+void register_placement() {
+  const auto nodes = zeus::numa_nodes();
+  const auto near = zeus::numa_node_cpus(nodes.front());
+
+  std::vector<std::pair<std::string, int>> consumers;
+  if (near.size() > 1) {
+    consumers.emplace_back("same-node", near[1]);
+  }
+  if (nodes.size() > 1) {
+    consumers.emplace_back("cross-node",
+                           zeus::numa_node_cpus(nodes[1]).front());
+  }
+
+  for (const auto& [label, consumer_cpu] : consumers) {
+    for (std::size_t n = 0; n < std::min<std::size_t>(nodes.size(), 2); ++n) {
+      benchmark::RegisterBenchmark(
+          ("placement/zeus::queue/8B/" + label + "/ring@node" +
+           std::to_string(nodes[n]))
+              .c_str(),
+          BM_Placement, near.front(), consumer_cpu, nodes[n])
+          ->UseRealTime();
+    }
+  }
+}
+
+/// Registers the throughput benchmarks of an adapter for every topology it
+/// supports. 1P1C runs with one and two threads, the other topologies with 2
+/// to 64 threads.
+template <template <typename> class Adapter, typename T>
+void register_throughput(const std::string& name) {
+  using Q = Adapter<T>;
+
+  const auto add = [&](const std::string& label, auto blocking, auto attempt,
+                       int min_threads) {
+    benchmark::RegisterBenchmark(("blocking/" + name + "/" + label).c_str(),
+                                 blocking)
+        ->ThreadRange(min_threads, label == "1P1C" ? 2 : 64)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark(("try/" + name + "/" + label).c_str(),
+                                 attempt)
+        ->ThreadRange(min_threads, label == "1P1C" ? 2 : 64)
+        ->UseRealTime();
+  };
+
+  add("1P1C", BM_Blocking<Q, T, topology::one_to_one>,
+      BM_Try<Q, T, topology::one_to_one>, 1);
+  if constexpr (Q::multi_producer) {
+    add("NP1C", BM_Blocking<Q, T, topology::many_to_one>,
+        BM_Try<Q, T, topology::many_to_one>, 2);
+  }
+  if constexpr (Q::multi_consumer) {
+    add("1PNC", BM_Blocking<Q, T, topology::one_to_many>,
+        BM_Try<Q, T, topology::one_to_many>, 2);
+  }
+  if constexpr (Q::multi_producer && Q::multi_consumer) {
+    add("NPNC", BM_Blocking<Q, T, topology::many_to_many>,
+        BM_Try<Q, T, topology::many_to_many>, 2);
+  }
+
+  benchmark::RegisterBenchmark(("latency/" + name).c_str(),
+                               BM_RoundTrip<Q, T>)
+      ->UseRealTime();
+}
+
+/// Registers the throughput benchmarks of an adapter for each payload size
+/// selected through ZEUS_BENCH_PAYLOADS, suffixing name with the size.
+template <template <typename> class Adapter>
+void register_payloads(const std::string& name) {
+  [&]<std::size_t... Sizes>(std::index_sequence<Sizes...>) {
+    ((payload_selected(Sizes)
+          ? register_throughput<Adapter, payload<Sizes>>(
+                name + "/" + std::to_string(Sizes) + "B")
+          : void()),
+     ...);
+  }(bench_payload_sizes{});
+}
+
+/// Prefetches slots eight tickets ahead of the head and tail.
+struct prefetch_traits : zeus::queue_traits {
+  static constexpr std::size_t prefetch_distance = 8;
+};
+
+template <typename T>
+using zeus_queue = zeus_adapter<T>;
+
+template <typename T>
+using zeus_prefetch_queue = zeus_adapter<T, prefetch_traits>;
+}  // namespace
+
+int main(int argc, char** argv) {
+  register_payloads<zeus_queue>("zeus::queue");
+  register_payloads<zeus_prefetch_queue>("zeus::queue+prefetch");
+  register_payloads<sharded_adapter>("zeus::sharded_queue");
+  register_payloads<spsc_adapter>("zeus::spsc_queue");
+  register_placement();
+#if defined(ZEUS_BENCH_BOOST)
+  register_payloads<boost_adapter>("boost::lockfree");
+#endif
+#if defined(ZEUS_BENCH_RIGTORP)
+  register_payloads<rigtorp_adapter>("rigtorp");
+#endif
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
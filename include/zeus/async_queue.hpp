@@ -0,0 +1,283 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "zeus/queue.hpp"
+#include "zeus/traits.hpp"
+
+namespace zeus {
+/// Executor that resumes coroutines inline on the thread that made their
+/// operation ready.
+struct inline_executor {
+  void execute(std::coroutine_handle<> handle) noexcept { handle.resume(); }
+};
+
+/// Coroutine front-end for zeus::queue. co_await async_pop() and
+/// co_await async_push(value) complete immediately when the queue is ready,
+/// and otherwise suspend the coroutine on a lock-free waiter stack. Whichever
+/// thread later frees a slot or publishes an item hands it to a waiting
+/// coroutine and resumes it through Executor::execute. Waiters are not woken
+/// in FIFO order.
+template <regular_type T,
+          typename Executor = inline_executor,
+          typename Traits = queue_traits>
+class async_queue {
+  /// Intrusive Treiber stack of waiters, linked through their next member.
+  template <typename W>
+  class waiter_stack {
+   public:
+    /// Pushes the chain of waiters starting at first.
+    void push_all(W* first) noexcept {
+      W* last = first;
+      while (last->next != nullptr) {
+        last = last->next;
+      }
+
+      W* current = top.load(std::memory_order_relaxed);
+      do {
+        last->next = current;
+      } while (!top.compare_exchange_weak(current, first,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_relaxed));
+#if !defined(__SANITIZE_THREAD__)
+      // Pairs with the fence in has_waiters(): either the waker sees these
+      // waiters or the caller's next check of the queue sees its update
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    /// Removes and returns every waiter as a chain.
+    W* take_all() noexcept {
+      return top.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    /// Returns true if a waiter is registered. Either the check observes a
+    /// concurrent push_all or the waiter pushed there observes every write
+    /// made before the check. Called after every operation, so it only
+    /// fences and reads top, keeping the line shared while nobody waits.
+    bool has_waiters() noexcept {
+#if defined(__SANITIZE_THREAD__)
+      // ThreadSanitizer does not model fences, so order through top instead
+      return top.fetch_add(0, std::memory_order_acq_rel) != nullptr;
+#else
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      return top.load(std::memory_order_relaxed) != nullptr;
+#endif
+    }
+
+   private:
+    std::atomic<W*> top = nullptr;
+  };
+
+ public:
+  /// Awaitable returned by async_pop(), resuming with the front item.
+  class pop_awaiter {
+   public:
+    bool await_ready() noexcept {
+      value = owner->try_pop();
+      return value.has_value();
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting) noexcept {
+      handle = awaiting;
+      next = nullptr;
+      // Another thread may resume and destroy the awaiter once it is pushed
+      async_queue* parent = owner;
+      parent->consumers.push_all(this);
+      parent->dispatch_consumers();
+    }
+
+    T await_resume() noexcept { return std::move(*value); }
+
+   private:
+    friend class async_queue;
+
+    explicit pop_awaiter(async_queue* owner) noexcept : owner(owner) {}
+
+    async_queue* owner;
+    pop_awaiter* next = nullptr;
+    std::coroutine_handle<> handle;
+    std::optional<T> value;
+  };
+
+  /// Awaitable returned by async_push(value), resuming once the item is
+  /// enqueued.
+  class push_awaiter {
+   public:
+    bool await_ready() noexcept { return owner->try_push(std::move(value)); }
+
+    void await_suspend(std::coroutine_handle<> awaiting) noexcept {
+      handle = awaiting;
+      next = nullptr;
+      // Another thread may resume and destroy the awaiter once it is pushed
+      async_queue* parent = owner;
+      parent->producers.push_all(this);
+      parent->dispatch_producers();
+    }
+
+    void await_resume() noexcept {}
+
+   private:
+    friend class async_queue;
+
+    template <typename P>
+    push_awaiter(async_queue* owner, P&& value) noexcept
+        : owner(owner), value(std::forward<P>(value)) {}
+
+    async_queue* owner;
+    push_awaiter* next = nullptr;
+    std::coroutine_handle<> handle;
+    T value;
+  };
+
+  /// Constructs a new queue with the provided capacity, resuming suspended
+  /// coroutines through executor.
+  explicit async_queue(const std::size_t capacity,
+                       Executor executor = Executor())
+      : executor(std::move(executor)), queue(capacity) {}
+
+  async_queue(const async_queue&) = delete;
+  async_queue& operator=(const async_queue&) = delete;
+
+  /// Returns an awaitable that removes the front item, suspending while the
+  /// queue is empty.
+  pop_awaiter async_pop() noexcept { return pop_awaiter(this); }
+
+  /// Returns an awaitable that enqueues value, suspending while the queue is
+  /// full.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value &&
+             std::is_nothrow_move_constructible<T>::value
+  push_awaiter async_push(P&& value) noexcept {
+    return push_awaiter(this, std::forward<P>(value));
+  }
+
+  /// Attempts to enqueue an item, waking a suspended consumer on success.
+  /// Returns true on success, false if the queue is full.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool try_push(P&& value) noexcept {
+    if (!queue.try_emplace(std::forward<P>(value))) {
+      return false;
+    }
+    wake_consumers();
+    return true;
+  }
+
+  /// Attempts to remove and return the front item, waking a suspended
+  /// producer on success. Returns an empty optional if the queue is empty.
+  std::optional<T> try_pop() noexcept {
+    auto rv = queue.try_pop();
+    if (rv) {
+      wake_producers();
+    }
+    return rv;
+  }
+
+  /// Returns the number of elements currently in the queue. The size is not
+  /// guaranteed to be accurate.
+  std::ptrdiff_t size() const noexcept { return queue.size(); }
+
+  /// Returns true if the queue is empty, otherwise false.
+  bool empty() const noexcept { return queue.empty(); }
+
+ private:
+  /// Dispatches items to suspended consumers if any are registered.
+  void wake_consumers() noexcept {
+    if (consumers.has_waiters()) {
+      dispatch_consumers();
+    }
+  }
+
+  /// Dispatches free slots to suspended producers if any are registered.
+  void wake_producers() noexcept {
+    if (producers.has_waiters()) {
+      dispatch_producers();
+    }
+  }
+
+  /// Hands available items to registered consumers and resumes them.
+  void dispatch_consumers() noexcept {
+    bool popped = false;
+
+    while (pop_awaiter* waiter = consumers.take_all()) {
+      while (waiter != nullptr) {
+        auto value = queue.try_pop();
+        if (!value) {
+          break;
+        }
+
+        // The waiter may be destroyed once resumed, so unlink it first
+        pop_awaiter* next = waiter->next;
+        waiter->value.emplace(std::move(*value));
+        executor.execute(waiter->handle);
+        waiter = next;
+        popped = true;
+      }
+
+      if (waiter == nullptr) {
+        break;
+      }
+
+      // Re-register the remaining waiters, then retry if an item was
+      // published meanwhile so that its producer's wake-up is not lost. An
+      // item claimed but not yet published is left to its producer, which
+      // checks for waiters once it publishes.
+      consumers.push_all(waiter);
+      if (queue.was_empty()) {
+        break;
+      }
+    }
+
+    if (popped) {
+      wake_producers();
+    }
+  }
+
+  /// Enqueues the items of registered producers and resumes them.
+  void dispatch_producers() noexcept {
+    bool pushed = false;
+
+    while (push_awaiter* waiter = producers.take_all()) {
+      while (waiter != nullptr) {
+        if (!queue.try_emplace(std::move(waiter->value))) {
+          break;
+        }
+
+        // The waiter may be destroyed once resumed, so unlink it first
+        push_awaiter* next = waiter->next;
+        executor.execute(waiter->handle);
+        waiter = next;
+        pushed = true;
+      }
+
+      if (waiter == nullptr) {
+        break;
+      }
+
+      // Re-register the remaining waiters, then retry if a slot was freed
+      // meanwhile so that its consumer's wake-up is not lost. A slot still
+      // being read is left to its consumer, which checks for waiters once
+      // it frees the slot.
+      producers.push_all(waiter);
+      if (queue.was_full()) {
+        break;
+      }
+    }
+
+    if (pushed) {
+      wake_consumers();
+    }
+  }
+
+  [[no_unique_address]] Executor executor;
+  zeus::queue<T, dynamic_capacity, Traits> queue;
+  waiter_stack<pop_awaiter> consumers;
+  waiter_stack<push_awaiter> producers;
+};
+}  // namespace zeus
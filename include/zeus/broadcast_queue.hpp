@@ -0,0 +1,249 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include "zeus/ring_index.hpp"
+#include "zeus/slot.hpp"
+#include "zeus/traits.hpp"
+
+namespace zeus {
+/// Single-producer queue in which every consumer receives every item, in the
+/// style of the LMAX Disruptor. Items are written once to a shared ring and
+/// each consumer follows the producer with its own read cursor. The number of
+/// consumers is fixed at construction, and consumer i must only be used by
+/// one thread at a time.
+///
+/// By default the producer is gated on the slowest consumer and blocks when
+/// it would overwrite an item that consumer has not read. When Lossy is true
+/// the producer never waits; instead each slot carries a sequence number that
+/// consumers check around the copy, seqlock style, and a consumer that was
+/// lapped skips to the oldest item still in the ring and counts the items it
+/// missed. Lossy queues require a trivially copyable T.
+template <typename T, bool Lossy = false, typename Traits = queue_traits>
+  requires std::is_nothrow_default_constructible<T>::value &&
+           std::is_nothrow_copy_constructible<T>::value &&
+           (Lossy ? std::is_trivially_copyable_v<T>
+                  : std::is_nothrow_copy_assignable<T>::value)
+class broadcast_queue {
+ public:
+  /// Constructs a new queue with the provided capacity and number of
+  /// consumers, each starting at the first item. At least one consumer is
+  /// required.
+  broadcast_queue(const std::size_t capacity, const std::size_t consumers)
+      : ring(capacity),
+        cells(std::make_unique<cell_type[]>(ring.capacity())),
+        readers(std::make_unique<reader[]>(consumers)),
+        reader_count(consumers) {}
+
+  broadcast_queue(const broadcast_queue&) = delete;
+  broadcast_queue& operator=(const broadcast_queue&) = delete;
+
+  /// Publishes a copy of value to every consumer. Blocks while the slowest
+  /// consumer is a full ring behind, unless the queue is lossy.
+  void push(const T& value) noexcept {
+    const auto sequence = cursor.load(std::memory_order_relaxed);
+    if constexpr (!Lossy) {
+      while (sequence - gate >= ring.capacity()) {
+        // Block while waiting for the slowest consumer to advance
+        const auto slowest = slowest_reader();
+        gate = readers[slowest].sequence.load(std::memory_order_acquire);
+        if (sequence - gate >= ring.capacity()) {
+          waiter.wait(readers[slowest].sequence,
+                      [this, sequence](auto current) {
+                        return sequence - current < ring.capacity();
+                      });
+        }
+      }
+    }
+
+    write(sequence, value);
+    cursor.store(sequence + 1, std::memory_order_release);
+    waiter.notify(cursor);
+  }
+
+  /// Attempts to publish a copy of value to every consumer. Returns true on
+  /// success, false if the slowest consumer is a full ring behind.
+  bool try_push(const T& value) noexcept
+    requires(!Lossy)
+  {
+    const auto sequence = cursor.load(std::memory_order_relaxed);
+    if (sequence - gate >= ring.capacity()) {
+      gate = readers[slowest_reader()].sequence.load(
+          std::memory_order_acquire);
+      if (sequence - gate >= ring.capacity()) {
+        return false;
+      }
+    }
+
+    write(sequence, value);
+    cursor.store(sequence + 1, std::memory_order_release);
+    waiter.notify(cursor);
+    return true;
+  }
+
+  /// Returns a copy of the next item for the given consumer, blocking while
+  /// it has read every published item.
+  T pop(std::size_t consumer) noexcept {
+    reader& self = readers[consumer];
+    while (true) {
+      const auto sequence = self.sequence.load(std::memory_order_relaxed);
+
+      // Block while waiting for the producer to publish the item
+      waiter.wait(cursor,
+                  [sequence](auto current) { return current > sequence; });
+
+      if (auto rv = read(self, sequence)) {
+        return *rv;
+      }
+    }
+  }
+
+  /// Attempts to return a copy of the next item for the given consumer.
+  /// Returns an empty optional if the consumer has read every published item.
+  std::optional<T> try_pop(std::size_t consumer) noexcept {
+    reader& self = readers[consumer];
+    while (true) {
+      const auto sequence = self.sequence.load(std::memory_order_relaxed);
+      if (cursor.load(std::memory_order_acquire) == sequence) {
+        return std::nullopt;
+      }
+      if (auto rv = read(self, sequence)) {
+        return rv;
+      }
+    }
+  }
+
+  /// Returns the number of items the given consumer skipped after being
+  /// overrun by the producer.
+  std::uint64_t dropped(std::size_t consumer) const noexcept
+    requires Lossy
+  {
+    return readers[consumer].dropped.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the number of published items the given consumer has not read.
+  /// The size is not guaranteed to be accurate.
+  std::size_t size(std::size_t consumer) const noexcept {
+    return cursor.load(std::memory_order_relaxed) -
+           readers[consumer].sequence.load(std::memory_order_relaxed);
+  }
+
+  /// Returns true if the given consumer has read every published item.
+  bool empty(std::size_t consumer) const noexcept {
+    return size(consumer) == 0;
+  }
+
+  /// Returns the number of items the ring can hold.
+  std::size_t capacity() const noexcept { return ring.capacity(); }
+
+  /// Returns the number of consumers.
+  std::size_t consumers() const noexcept { return reader_count; }
+
+ private:
+  /// Slot of a lossy queue. The item is stored in atomic words so that a
+  /// consumer racing an overwrite reads a torn copy instead of causing a data
+  /// race, and discards it when the sequence changed around the copy.
+  struct lossy_cell {
+    static constexpr std::size_t words =
+        (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    /// 2n + 1 while item n is written, 2n + 2 once it is complete.
+    std::atomic_size_t sequence = 0;
+    std::atomic_uint64_t data[words] = {};
+  };
+
+  using cell_type = std::conditional_t<Lossy, lossy_cell, T>;
+
+  /// Read cursor of one consumer.
+  struct alignas(hw_inf_size) reader {
+    std::atomic_size_t sequence = 0;
+    std::atomic_uint64_t dropped = 0;
+  };
+
+  /// Writes item sequence into its slot.
+  void write(std::size_t sequence, const T& value) noexcept {
+    cell_type& cell = cells[ring.get_idx(sequence)];
+    if constexpr (Lossy) {
+      std::uint64_t buffer[lossy_cell::words] = {};
+      std::memcpy(buffer, &value, sizeof(T));
+
+      // A consumer that reads any new word also sees the odd sequence
+      cell.sequence.store(sequence * 2 + 1, std::memory_order_relaxed);
+      for (std::size_t i = 0; i < lossy_cell::words; ++i) {
+        cell.data[i].store(buffer[i], std::memory_order_release);
+      }
+      cell.sequence.store(sequence * 2 + 2, std::memory_order_release);
+    } else {
+      cell = value;
+    }
+  }
+
+  /// Copies the published item sequence for consumer self and advances its
+  /// cursor. Returns an empty optional if the item was overwritten, after
+  /// moving the cursor to the oldest item still in the ring.
+  std::optional<T> read(reader& self, std::size_t sequence) noexcept {
+    const cell_type& cell = cells[ring.get_idx(sequence)];
+    if constexpr (Lossy) {
+      const auto before = cell.sequence.load(std::memory_order_acquire);
+      std::uint64_t buffer[lossy_cell::words];
+      for (std::size_t i = 0; i < lossy_cell::words; ++i) {
+        buffer[i] = cell.data[i].load(std::memory_order_acquire);
+      }
+      const auto after = cell.sequence.load(std::memory_order_relaxed);
+
+      if (before != sequence * 2 + 2 || after != before) {
+        // Skip to the oldest item the producer cannot be overwriting
+        const auto newest = cursor.load(std::memory_order_acquire);
+        const auto oldest = newest - ring.capacity() + 1;
+        self.dropped.fetch_add(oldest - sequence, std::memory_order_relaxed);
+        self.sequence.store(oldest, std::memory_order_relaxed);
+        return std::nullopt;
+      }
+
+      std::optional<T> rv(std::in_place);
+      std::memcpy(&*rv, buffer, sizeof(T));
+      self.sequence.store(sequence + 1, std::memory_order_relaxed);
+      return rv;
+    } else {
+      std::optional<T> rv(cell);
+      self.sequence.store(sequence + 1, std::memory_order_release);
+      waiter.notify(self.sequence);
+      return rv;
+    }
+  }
+
+  /// Returns the index of the consumer furthest behind the producer. Every
+  /// cursor is loaded with acquire so that the reads of each consumer happen
+  /// before the producer overwrites the slots they left.
+  std::size_t slowest_reader() const noexcept {
+    std::size_t slowest = 0;
+    auto lowest = std::numeric_limits<std::size_t>::max();
+    for (std::size_t i = 0; i < reader_count; ++i) {
+      const auto sequence = readers[i].sequence.load(std::memory_order_acquire);
+      if (sequence < lowest) {
+        lowest = sequence;
+        slowest = i;
+      }
+    }
+    return slowest;
+  }
+
+  [[no_unique_address]] ring_index<dynamic_capacity, Traits::power_of_two>
+      ring;
+  std::unique_ptr<cell_type[]> cells;
+  std::unique_ptr<reader[]> readers;
+  const std::size_t reader_count;
+  [[no_unique_address]] typename Traits::wait_strategy waiter;
+
+  // Producer-side state: published sequence and cached slowest consumer
+  alignas(hw_inf_size) std::atomic_size_t cursor = 0;
+  alignas(hw_inf_size) std::size_t gate = 0;
+};
+}  // namespace zeus
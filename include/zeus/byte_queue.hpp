@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#include "zeus/slot.hpp"
+#include "zeus/traits.hpp"
+#include "zeus/wait.hpp"
+
+namespace zeus {
+/// Bounded queue of variable-length byte records supporting multiple
+/// producers and consumers. Records are stored contiguously in a single ring
+/// buffer and are written and read in place through reservations. The length
+/// of each record is kept in an atomic header word indexed like the block the
+/// record starts at. Producers claim space with a CAS on the head and
+/// publish their records in claim order. Consumers read the header of the
+/// front record without locking and claim it with a CAS on the tail, which
+/// fails if another consumer claimed it first and the header read was stale.
+/// They release their space in claim order, mirroring the slot turns of
+/// zeus::queue. Blocking operations wait through Traits::wait_strategy.
+template <typename Traits = queue_traits>
+class byte_queue {
+ public:
+  /// Exclusive write access to a claimed record. The record becomes visible
+  /// to consumers on commit, or when the reservation is destroyed.
+  class push_reservation {
+   public:
+    push_reservation(push_reservation&& other) noexcept
+        : owner(std::exchange(other.owner, nullptr)),
+          first(other.first),
+          last(other.last),
+          bytes(other.bytes) {}
+
+    ~push_reservation() noexcept { commit(); }
+
+    push_reservation(const push_reservation&) = delete;
+    push_reservation& operator=(const push_reservation&) = delete;
+    push_reservation& operator=(push_reservation&&) = delete;
+
+    /// Returns the bytes of the record.
+    std::span<std::byte> data() const noexcept { return bytes; }
+
+    /// Returns true if the reservation holds a record.
+    explicit operator bool() const noexcept { return owner != nullptr; }
+
+    /// Publishes the record to consumers once every earlier record has been
+    /// published.
+    void commit() noexcept {
+      if (owner != nullptr) {
+        owner->advance(owner->published, first, last);
+        owner = nullptr;
+      }
+    }
+
+   private:
+    friend class byte_queue;
+
+    push_reservation(byte_queue* owner,
+                     std::size_t first,
+                     std::size_t last,
+                     std::span<std::byte> bytes) noexcept
+        : owner(owner), first(first), last(last), bytes(bytes) {}
+
+    byte_queue* owner;
+    std::size_t first;
+    std::size_t last;
+    std::span<std::byte> bytes;
+  };
+
+  /// Exclusive read access to a claimed record. The space of the record is
+  /// handed back to producers on release, or when the reservation is
+  /// destroyed.
+  class pop_reservation {
+   public:
+    pop_reservation(pop_reservation&& other) noexcept
+        : owner(std::exchange(other.owner, nullptr)),
+          first(other.first),
+          last(other.last),
+          bytes(other.bytes) {}
+
+    ~pop_reservation() noexcept { release(); }
+
+    pop_reservation(const pop_reservation&) = delete;
+    pop_reservation& operator=(const pop_reservation&) = delete;
+    pop_reservation& operator=(pop_reservation&&) = delete;
+
+    /// Returns the bytes of the record.
+    std::span<const std::byte> data() const noexcept { return bytes; }
+
+    /// Releases the space of the record once every earlier record has been
+    /// released.
+    void release() noexcept {
+      if (owner != nullptr) {
+        owner->advance(owner->released, first, last);
+        owner = nullptr;
+      }
+    }
+
+   private:
+    friend class byte_queue;
+
+    pop_reservation(byte_queue* owner,
+                    std::size_t first,
+                    std::size_t last,
+                    std::span<const std::byte> bytes) noexcept
+        : owner(owner), first(first), last(last), bytes(bytes) {}
+
+    byte_queue* owner;
+    std::size_t first;
+    std::size_t last;
+    std::span<const std::byte> bytes;
+  };
+
+  /// Constructs a new queue with a buffer of at least capacity bytes.
+  explicit byte_queue(const std::size_t capacity)
+      : blocks(std::max<std::size_t>((capacity + block_size - 1) / block_size,
+                                     4)),
+        buffer(std::make_unique<std::uint64_t[]>(blocks)),
+        headers(std::make_unique<std::atomic_uint64_t[]>(blocks)) {}
+
+  byte_queue(const byte_queue&) = delete;
+  byte_queue& operator=(const byte_queue&) = delete;
+
+  /// Claims space for a record of size bytes, blocking while the queue is
+  /// full. The reservation is empty if size exceeds max_record_size().
+  push_reservation begin_push(std::size_t size) noexcept {
+    if (size > max_record_size()) {
+      return push_reservation(nullptr, 0, 0, {});
+    }
+    auto current_head = head.load(std::memory_order_acquire);
+
+    while (true) {
+      const auto claim = claim_size(current_head, size);
+
+      // Block while waiting for consumers to release enough space
+      waiter.wait(released, [this, current_head, claim](auto current) {
+        return current_head + claim <= current + blocks;
+      });
+
+      if (head.compare_exchange_strong(current_head, current_head + claim)) {
+        return prepare(current_head, claim, size);
+      }
+    }
+  }
+
+  /// Attempts to claim space for a record of size bytes. Returns an empty
+  /// optional if the queue does not have enough free space or size exceeds
+  /// max_record_size().
+  std::optional<push_reservation> try_begin_push(std::size_t size) noexcept {
+    if (size > max_record_size()) {
+      return std::nullopt;
+    }
+    auto current_head = head.load(std::memory_order_acquire);
+
+    while (true) {
+      const auto claim = claim_size(current_head, size);
+      if (current_head + claim >
+          released.load(std::memory_order_acquire) + blocks) {
+        return std::nullopt;
+      }
+
+      if (head.compare_exchange_strong(current_head, current_head + claim)) {
+        return prepare(current_head, claim, size);
+      }
+    }
+  }
+
+  /// Claims the front record, blocking while the queue is empty.
+  pop_reservation begin_pop() noexcept {
+    while (true) {
+      const auto position = tail.load(std::memory_order_acquire);
+
+      // Block while waiting for a published record
+      waiter.wait(published,
+                  [position](auto current) { return current != position; });
+
+      if (auto reservation = try_begin_pop()) {
+        return std::move(*reservation);
+      }
+    }
+  }
+
+  /// Attempts to claim the front record. Returns an empty optional if the
+  /// queue is empty.
+  std::optional<pop_reservation> try_begin_pop() noexcept {
+    auto current_tail = tail.load(std::memory_order_acquire);
+
+    while (true) {
+      if (published.load(std::memory_order_acquire) == current_tail) {
+        return std::nullopt;
+      }
+
+      // The header may be stale if another consumer claimed the record and
+      // producers reused its space, in which case the tail moved and the CAS
+      // fails
+      auto [length, size] = load_header(current_tail % blocks);
+      auto last = current_tail + length;
+
+      // Skip the padding at the end of the buffer
+      if (size == padding) {
+        std::tie(length, size) = load_header(last % blocks);
+        last += length;
+      }
+
+      if (tail.compare_exchange_weak(current_tail, last,
+                                     std::memory_order_acquire)) {
+        const auto index = (last - length) % blocks;
+        return pop_reservation(
+            this, current_tail, last,
+            {reinterpret_cast<const std::byte*>(&buffer[index]), size});
+      }
+    }
+  }
+
+  /// Enqueues a copy of record, blocking while the queue is full. Returns
+  /// false if the record exceeds max_record_size().
+  bool push(std::span<const std::byte> record) noexcept {
+    auto reservation = begin_push(record.size());
+    if (!reservation) {
+      return false;
+    }
+    std::memcpy(reservation.data().data(), record.data(), record.size());
+    return true;
+  }
+
+  /// Attempts to enqueue a copy of record. Returns true on success, false if
+  /// the queue does not have enough free space or the record exceeds
+  /// max_record_size().
+  bool try_push(std::span<const std::byte> record) noexcept {
+    auto reservation = try_begin_push(record.size());
+    if (!reservation) {
+      return false;
+    }
+    std::memcpy(reservation->data().data(), record.data(), record.size());
+    return true;
+  }
+
+  /// Returns the largest record size accepted by the queue: half the buffer,
+  /// and below the padding marker so that the size fits its header.
+  std::size_t max_record_size() const noexcept {
+    return std::min<std::size_t>(blocks / 2 * block_size, padding - 1);
+  }
+
+  /// Returns the number of buffer bytes currently claimed by records. The
+  /// size is not guaranteed to be accurate.
+  std::size_t size() const noexcept {
+    return (head.load(std::memory_order_relaxed) -
+            released.load(std::memory_order_relaxed)) *
+           block_size;
+  }
+
+  /// Returns true if the queue is empty, otherwise false.
+  bool empty() const noexcept {
+    return published.load(std::memory_order_relaxed) ==
+           tail.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /// Granularity of the buffer. Every record takes at least one block, so
+  /// that records start at distinct positions.
+  static constexpr std::size_t block_size = sizeof(std::uint64_t);
+
+  /// Size marking a header that pads the end of the buffer. Record sizes stay
+  /// below it.
+  static constexpr std::uint32_t padding = UINT32_MAX;
+
+  /// Returns the number of blocks, including any padding up to the end of the
+  /// buffer, claimed at position for a record of size bytes.
+  std::size_t claim_size(std::size_t position, std::size_t size) const
+      noexcept {
+    const auto needed = record_blocks(size);
+    const auto index = position % blocks;
+    return index + needed > blocks ? blocks - index + needed : needed;
+  }
+
+  /// Returns the number of blocks holding a record of size bytes.
+  static constexpr std::size_t record_blocks(std::size_t size) noexcept {
+    return std::max<std::size_t>((size + block_size - 1) / block_size, 1);
+  }
+
+  /// Writes the headers of a claim of claim blocks at position and returns
+  /// the reservation of the record.
+  push_reservation prepare(std::size_t position,
+                           std::size_t claim,
+                           std::size_t size) noexcept {
+    const auto needed = record_blocks(size);
+    auto index = position % blocks;
+
+    // Skip to the start of the buffer if the record does not fit before the
+    // end
+    if (claim != needed) {
+      store_header(index, claim - needed, padding);
+      index = 0;
+    }
+
+    store_header(index, needed, static_cast<std::uint32_t>(size));
+    return push_reservation(
+        this, position, position + claim,
+        {reinterpret_cast<std::byte*>(&buffer[index]), size});
+  }
+
+  /// Advances counter from first to last once it reaches first.
+  void advance(std::atomic_size_t& counter,
+               std::size_t first,
+               std::size_t last) noexcept {
+    // Block while waiting for earlier claims to complete
+    waiter.wait(counter, [first](auto current) { return current == first; });
+
+    counter.store(last, std::memory_order_release);
+    waiter.notify(counter);
+  }
+
+  /// Stores the header of a record of length blocks and size bytes at the
+  /// block index. Headers live outside the buffer in atomic words, because a
+  /// consumer holding a stale tail may read one while it is overwritten; the
+  /// release of published orders them for the consumers that claim the
+  /// record.
+  void store_header(std::size_t index,
+                    std::size_t length,
+                    std::uint32_t size) noexcept {
+    headers[index].store(static_cast<std::uint64_t>(length) << 32 | size,
+                         std::memory_order_relaxed);
+  }
+
+  /// Loads the length in blocks and the size in bytes of the record header at
+  /// the block index.
+  std::pair<std::size_t, std::uint32_t> load_header(
+      std::size_t index) noexcept {
+    const auto header = headers[index].load(std::memory_order_relaxed);
+    return {static_cast<std::size_t>(header >> 32),
+            static_cast<std::uint32_t>(header)};
+  }
+
+  const std::size_t blocks;
+  std::unique_ptr<std::uint64_t[]> buffer;
+  std::unique_ptr<std::atomic_uint64_t[]> headers;
+  [[no_unique_address]] typename Traits::wait_strategy waiter;
+
+  // Producer-side counters: claimed and published positions
+  alignas(hw_inf_size) std::atomic_size_t head = 0;
+  alignas(hw_inf_size) std::atomic_size_t published = 0;
+
+  // Consumer-side counters: claimed and released positions
+  alignas(hw_inf_size) std::atomic_size_t tail = 0;
+  alignas(hw_inf_size) std::atomic_size_t released = 0;
+};
+}  // namespace zeus
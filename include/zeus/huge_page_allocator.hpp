@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "zeus/topology.hpp"
+
+namespace zeus {
+/// Value of huge_page_options::numa_node that binds the mapping to the NUMA
+/// node of the thread calling allocate.
+inline constexpr int local_numa_node = -2;
+
+/// Configuration of the memory returned by zeus::huge_page_allocator.
+struct huge_page_options {
+  /// Size of the pages backing the mapping, typically 2 MiB or 1 GiB. Zero
+  /// requests regular pages with transparent huge pages enabled. Allocations
+  /// smaller than one such page always use regular pages, so that small
+  /// objects such as a queue control block do not take a whole huge page.
+  std::size_t page_size = std::size_t{2} << 20;
+  /// NUMA node the mapping is bound to, local_numa_node for the node of the
+  /// allocating thread, or -1 to use the default policy.
+  int numa_node = -1;
+  /// Faults in every page at allocation time so that the hot path never takes
+  /// a page fault.
+  bool prefault = true;
+  /// Falls back to regular pages when no huge pages are available.
+  bool fallback = true;
+};
+
+/// Allocator mapping anonymous memory with mmap, optionally on explicit huge
+/// pages, bound to a NUMA node and prefaulted. Mappings are page-aligned, so
+/// the alignment of any T is honored. Only available on Linux.
+template <typename T>
+class huge_page_allocator {
+ public:
+  using value_type = T;
+
+  /// Anonymous mappings are zero-filled, which queue_traits::lazy_init relies
+  /// on.
+  static constexpr bool zero_filled = true;
+
+  huge_page_allocator() noexcept = default;
+
+  explicit huge_page_allocator(const huge_page_options& options) noexcept
+      : options(options) {}
+
+  template <typename U>
+  huge_page_allocator(const huge_page_allocator<U>& other) noexcept
+      : options(other.get_options()) {}
+
+  /// Maps memory for n objects of type T. Throws std::bad_alloc on failure.
+  T* allocate(std::size_t n) {
+#if defined(__linux__)
+    const std::size_t bytes = mapping_size(n);
+    const bool huge = uses_huge_pages(n);
+    void* memory = MAP_FAILED;
+
+    if (huge) {
+      const int page_shift = __builtin_ctzll(options.page_size);
+      memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                        (page_shift << MAP_HUGE_SHIFT),
+                    -1, 0);
+    }
+
+    std::size_t stride = options.page_size;
+    if (memory == MAP_FAILED) {
+      if (huge && !options.fallback) {
+        throw std::bad_alloc();
+      }
+      memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (memory == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      if (huge || options.page_size == 0) {
+        madvise(memory, bytes, MADV_HUGEPAGE);
+      }
+      stride = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    if (options.numa_node != -1 && !bind(memory, bytes)) {
+      munmap(memory, bytes);
+      throw std::bad_alloc();
+    }
+
+    // Touch one byte per page so that the first writes on the hot path do not
+    // fault; pages are zero-filled, so storing zero is harmless
+    if (options.prefault) {
+      auto* bytes_ptr = static_cast<volatile unsigned char*>(memory);
+      for (std::size_t offset = 0; offset < bytes; offset += stride) {
+        bytes_ptr[offset] = 0;
+      }
+    }
+
+    return static_cast<T*>(memory);
+#else
+    (void)n;
+    throw std::bad_alloc();
+#endif
+  }
+
+  /// Unmaps memory previously returned by allocate(n).
+  void deallocate(T* pointer, std::size_t n) noexcept {
+#if defined(__linux__)
+    munmap(pointer, mapping_size(n));
+#else
+    (void)pointer;
+    (void)n;
+#endif
+  }
+
+  /// Returns the options the allocator was constructed with.
+  const huge_page_options& get_options() const noexcept { return options; }
+
+  template <typename U>
+  bool operator==(const huge_page_allocator<U>& other) const noexcept {
+    const auto& rhs = other.get_options();
+    return options.page_size == rhs.page_size &&
+           options.numa_node == rhs.numa_node &&
+           options.prefault == rhs.prefault &&
+           options.fallback == rhs.fallback;
+  }
+
+ private:
+  /// Returns true if n objects are mapped on explicit huge pages: a page size
+  /// is configured and they fill at least one page.
+  bool uses_huge_pages(std::size_t n) const noexcept {
+    return options.page_size != 0 && n * sizeof(T) >= options.page_size;
+  }
+
+  /// Returns the size of the mapping holding n objects, rounded up to a whole
+  /// number of pages.
+  std::size_t mapping_size(std::size_t n) const noexcept {
+    std::size_t page = options.page_size;
+#if defined(__linux__)
+    if (!uses_huge_pages(n)) {
+      page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return (n * sizeof(T) + page - 1) / page * page;
+  }
+
+#if defined(__linux__)
+  /// Binds the mapping to the configured NUMA node with mbind(MPOL_BIND).
+  bool bind(void* memory, std::size_t bytes) const noexcept {
+    constexpr int mpol_bind = 2;
+    constexpr std::size_t mask_bits = 1024;
+    const int numa_node = options.numa_node == local_numa_node
+                              ? current_numa_node()
+                              : options.numa_node;
+    const auto node = static_cast<std::size_t>(numa_node);
+    if (numa_node < 0 || node >= mask_bits) {
+      return false;
+    }
+
+    unsigned long mask[mask_bits / (8 * sizeof(unsigned long))] = {};
+    mask[node / (8 * sizeof(unsigned long))] |=
+        1UL << (node % (8 * sizeof(unsigned long)));
+    return syscall(SYS_mbind, memory, bytes, mpol_bind, mask, mask_bits + 1,
+                   0) == 0;
+  }
+#endif
+
+  huge_page_options options;
+};
+
+/// Deleter of objects created by make_placed, which destroys the object and
+/// unmaps its memory.
+template <typename T>
+struct placed_deleter {
+  huge_page_options options;
+
+  void operator()(T* pointer) const noexcept {
+    pointer->~T();
+    huge_page_allocator<T>(options).deallocate(pointer, 1);
+  }
+};
+
+template <typename T>
+using placed_ptr = std::unique_ptr<T, placed_deleter<T>>;
+
+/// Constructs a T in memory mapped with the given options. Used to place the
+/// control block of a queue, with its head and tail, on a NUMA node; the slot
+/// array is placed through the allocator in its traits. A T smaller than
+/// options.page_size lands on regular pages. Throws std::bad_alloc on
+/// failure.
+template <typename T, typename... A>
+placed_ptr<T> make_placed(const huge_page_options& options, A&&... arguments) {
+  huge_page_allocator<T> allocator(options);
+  T* pointer = allocator.allocate(1);
+  try {
+    new (pointer) T(std::forward<A>(arguments)...);
+  } catch (...) {
+    allocator.deallocate(pointer, 1);
+    throw;
+  }
+  return placed_ptr<T>(pointer, placed_deleter<T>{options});
+}
+}  // namespace zeus
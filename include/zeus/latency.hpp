@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "zeus/slot.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace zeus {
+/// Returns a timestamp for latency tracing: the time-stamp counter on x86,
+/// in cycles, and steady_clock nanoseconds elsewhere.
+inline std::uint64_t trace_timestamp() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+/// Point-in-time copy of a residency histogram. Values are bucketed
+/// log-linearly, HDR style: each power of two is split into sub_buckets
+/// buckets, so a bucket bounds its values within 1 / sub_buckets.
+struct latency_snapshot {
+  static constexpr std::size_t sub_bucket_bits = 3;
+  static constexpr std::size_t sub_buckets = std::size_t{1}
+                                             << sub_bucket_bits;
+  static constexpr std::size_t buckets =
+      (64 - sub_bucket_bits + 1) * sub_buckets;
+
+  /// Returns the bucket holding value.
+  static constexpr std::size_t bucket_of(std::uint64_t value) noexcept {
+    if (value < sub_buckets) {
+      return static_cast<std::size_t>(value);
+    }
+    const auto shift =
+        static_cast<std::size_t>(std::bit_width(value)) - sub_bucket_bits - 1;
+    return (shift + 1) * sub_buckets +
+           static_cast<std::size_t>((value >> shift) - sub_buckets);
+  }
+
+  /// Returns the largest value held by bucket.
+  static constexpr std::uint64_t bucket_limit(std::size_t bucket) noexcept {
+    if (bucket < sub_buckets) {
+      return bucket;
+    }
+    const auto shift = bucket / sub_buckets - 1;
+    const auto base = sub_buckets + bucket % sub_buckets;
+    return ((std::uint64_t{base} + 1) << shift) - 1;
+  }
+
+  /// Returns the number of recorded values.
+  std::uint64_t count() const noexcept {
+    std::uint64_t total = 0;
+    for (const auto bucket : counts) {
+      total += bucket;
+    }
+    return total;
+  }
+
+  /// Returns an upper bound of the value at quantile q, between 0 and 1, or
+  /// zero if nothing was recorded.
+  std::uint64_t percentile(double q) const noexcept {
+    const auto total = count();
+    if (total == 0) {
+      return 0;
+    }
+    const auto rank = static_cast<std::uint64_t>(
+        q * static_cast<double>(total - 1));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets; ++i) {
+      seen += counts[i];
+      if (seen > rank) {
+        return bucket_limit(i);
+      }
+    }
+    return bucket_limit(buckets - 1);
+  }
+
+  /// Number of values recorded in each bucket.
+  std::array<std::uint64_t, buckets> counts{};
+};
+
+/// Tracing policy that records nothing. Slots carry no timestamp, so tracing
+/// compiles out of the queue.
+struct no_tracing {
+  static constexpr bool enabled = false;
+
+  void record(std::uint64_t) noexcept {}
+};
+
+/// Tracing policy that records how long items reside in the queue, from the
+/// timestamp stored in the slot on enqueue to the dequeue, in
+/// trace_timestamp() ticks. Consumers are assigned round-robin to Shards
+/// histograms, each on its own cache lines, so that up to Shards consumers
+/// never contend on a bucket.
+template <std::size_t Shards = 16>
+class residency_histogram {
+ public:
+  static constexpr bool enabled = true;
+
+  /// Records a residency of ticks.
+  void record(std::uint64_t ticks) noexcept {
+    local().counts[latency_snapshot::bucket_of(ticks)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  /// Returns the sum of every shard. Buckets are read individually, so the
+  /// snapshot is not atomic with respect to concurrent operations.
+  latency_snapshot snapshot() const noexcept {
+    latency_snapshot totals;
+    for (const shard& histogram : shards) {
+      for (std::size_t i = 0; i < latency_snapshot::buckets; ++i) {
+        totals.counts[i] +=
+            histogram.counts[i].load(std::memory_order_relaxed);
+      }
+    }
+    return totals;
+  }
+
+ private:
+  /// Histogram updated by the consumers assigned to one shard.
+  struct alignas(hw_inf_size) shard {
+    std::atomic_uint64_t counts[latency_snapshot::buckets] = {};
+  };
+
+  /// Returns the shard assigned to the calling thread.
+  shard& local() noexcept {
+    static std::atomic_size_t next_thread = 0;
+    thread_local const std::size_t thread =
+        next_thread.fetch_add(1, std::memory_order_relaxed);
+    return shards[thread % Shards];
+  }
+
+  shard shards[Shards];
+};
+}  // namespace zeus
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+#include "zeus/slot.hpp"
+
+namespace zeus {
+/// Pads every slot to a full cache line so that neighboring tickets never
+/// share a line. Fastest under contention, but costs hw_inf_size bytes per
+/// slot.
+struct padded_layout {
+  static constexpr std::size_t alignment = hw_inf_size;
+  static constexpr bool scramble = false;
+};
+
+/// Packs the turn counter and storage of each slot tightly. Minimizes the
+/// memory footprint at the cost of false sharing between neighboring tickets.
+struct compact_layout {
+  static constexpr std::size_t alignment = alignof(std::atomic_size_t);
+  static constexpr bool scramble = false;
+};
+
+/// Packs slots tightly like compact_layout, but permutes ring indices so that
+/// consecutive tickets land on different cache lines. Requires a power-of-two
+/// capacity.
+struct scrambled_layout {
+  static constexpr std::size_t alignment = alignof(std::atomic_size_t);
+  static constexpr bool scramble = true;
+};
+
+/// Identity permutation of ring indices used by unscrambled layouts.
+struct identity_scrambler {
+  constexpr identity_scrambler(std::size_t, std::size_t) noexcept {}
+
+  constexpr std::size_t operator()(std::size_t i) const noexcept { return i; }
+};
+
+/// Permutes ring indices of a power-of-two ring by swapping the bits that
+/// select a slot within a cache line with the bits that select the line, so
+/// that consecutive indices are spread over consecutive lines.
+class index_scrambler {
+ public:
+  constexpr index_scrambler(std::size_t capacity,
+                            std::size_t slot_size) noexcept
+      : bits(std::min(
+            std::countr_zero(std::bit_floor(
+                std::max<std::size_t>(hw_inf_size / slot_size, 1))),
+            std::countr_zero(capacity) / 2)) {}
+
+  constexpr std::size_t operator()(std::size_t i) const noexcept {
+    const std::size_t mix = (i ^ (i >> bits)) & ((std::size_t{1} << bits) - 1);
+    return i ^ mix ^ (mix << bits);
+  }
+
+ private:
+  int bits;
+};
+}  // namespace zeus
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include "zeus/ring_index.hpp"
+#include "zeus/slot.hpp"
+#include "zeus/traits.hpp"
+#include "zeus/wait.hpp"
+
+namespace zeus {
+/// Lossy multi-producer/multi-consumer queue that overwrites the oldest item
+/// instead of blocking or rejecting producers, for telemetry and snapshots
+/// where only recent items matter. Producers claim tickets with a single
+/// fetch_add and never wait for consumers. Each slot carries a version
+/// checked around the copy, seqlock style: a consumer that finds its item
+/// overwritten, or torn by a concurrent write, skips every consumer to the
+/// oldest item still in the ring, adding the items skipped to a count shared
+/// by the queue.
+///
+/// Producers do wait for each other in one case: when a producer a full ring
+/// behind is still writing the same slot, for example because it was
+/// preempted mid-write, the later producer waits for that write to finish.
+/// Requires a trivially copyable T.
+template <typename T, typename Traits = queue_traits>
+  requires std::is_trivially_copyable_v<T> &&
+           std::is_nothrow_default_constructible<T>::value
+class overwrite_queue {
+ public:
+  /// Constructs a new queue with the provided capacity.
+  explicit overwrite_queue(const std::size_t capacity)
+      : ring(capacity), cells(std::make_unique<cell[]>(ring.capacity())) {}
+
+  overwrite_queue(const overwrite_queue&) = delete;
+  overwrite_queue& operator=(const overwrite_queue&) = delete;
+
+  /// Enqueues a copy of value, overwriting the oldest item if the queue is
+  /// full. Always succeeds, but waits while a producer a full ring behind is
+  /// still writing the same slot.
+  void push(const T& value) noexcept {
+    const auto ticket = head.fetch_add(1);
+    cell& slot = cells[ring.get_idx(ticket)];
+    const auto writing = ticket * 2 + 1;
+
+    auto version = slot.version.load(std::memory_order_acquire);
+    while (true) {
+      if (version >= writing) {
+        // A newer item already took the slot, so this one is overwritten
+        // before it is even written
+        return;
+      }
+      if (version % 2 == 1) {
+        // Block while waiting for the producer a ring behind to finish
+        waiter.wait(slot.version, [writing](auto current) {
+          return current % 2 == 0 || current >= writing;
+        });
+        version = slot.version.load(std::memory_order_acquire);
+      } else if (slot.version.compare_exchange_weak(
+                     version, writing, std::memory_order_acq_rel,
+                     std::memory_order_acquire)) {
+        break;
+      }
+    }
+
+    std::uint64_t buffer[cell::words] = {};
+    std::memcpy(buffer, &value, sizeof(T));
+    // A consumer that reads any new word also sees the odd version
+    for (std::size_t i = 0; i < cell::words; ++i) {
+      slot.data[i].store(buffer[i], std::memory_order_release);
+    }
+    slot.version.store(writing + 1, std::memory_order_release);
+    waiter.notify(slot.version);
+  }
+
+  /// Removes and returns the front item, blocking while the queue is empty.
+  T pop() noexcept {
+    while (true) {
+      const auto current_tail = tail.load(std::memory_order_acquire);
+      const auto published = current_tail * 2 + 2;
+
+      // Block while waiting for the item of the ticket, or a newer one
+      waiter.wait(cells[ring.get_idx(current_tail)].version,
+                  [published](auto version) { return version >= published; });
+
+      if (auto rv = take(current_tail)) {
+        return *rv;
+      }
+    }
+  }
+
+  /// Attempts to remove and return the front item. Returns an empty optional
+  /// if the queue is empty or the front item is still being written.
+  std::optional<T> try_pop() noexcept {
+    while (true) {
+      const auto current_tail = tail.load(std::memory_order_acquire);
+      const auto version =
+          cells[ring.get_idx(current_tail)].version.load(
+              std::memory_order_acquire);
+      if (version < current_tail * 2 + 2) {
+        return std::nullopt;
+      }
+      if (auto rv = take(current_tail)) {
+        return rv;
+      }
+    }
+  }
+
+  /// Returns the number of items overwritten before any consumer removed
+  /// them. Consumers share one tail, so the count is global: it is not
+  /// attributed to the consumer that happened to skip the items.
+  std::uint64_t dropped() const noexcept {
+    return skipped.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the number of items in the queue, at most capacity(). The size
+  /// is not guaranteed to be accurate.
+  std::size_t size() const noexcept {
+    const auto difference = static_cast<std::ptrdiff_t>(
+        head.load(std::memory_order_relaxed) -
+        tail.load(std::memory_order_relaxed));
+    return static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(
+        difference, 0, static_cast<std::ptrdiff_t>(ring.capacity())));
+  }
+
+  /// Returns true if the queue is empty, otherwise false.
+  bool empty() const noexcept { return size() == 0; }
+
+  /// Returns the number of items the ring can hold.
+  std::size_t capacity() const noexcept { return ring.capacity(); }
+
+ private:
+  /// Slot holding an item in atomic words, so that a consumer racing an
+  /// overwrite reads a torn copy instead of causing a data race, and
+  /// discards it when the version changed around the copy.
+  struct cell {
+    static constexpr std::size_t words =
+        (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    /// 2n + 1 while the item of ticket n is written, 2n + 2 once complete.
+    std::atomic_size_t version = 0;
+    std::atomic_uint64_t data[words] = {};
+  };
+
+  /// Copies the item of ticket and claims it. Returns an empty optional if
+  /// another consumer claimed it first or it was overwritten, after moving
+  /// tail to the oldest item still in the ring.
+  std::optional<T> take(std::size_t ticket) noexcept {
+    const cell& slot = cells[ring.get_idx(ticket)];
+    const auto before = slot.version.load(std::memory_order_acquire);
+    std::uint64_t buffer[cell::words];
+    for (std::size_t i = 0; i < cell::words; ++i) {
+      buffer[i] = slot.data[i].load(std::memory_order_acquire);
+    }
+    const auto after = slot.version.load(std::memory_order_relaxed);
+
+    if (before == ticket * 2 + 2 && after == before) {
+      auto expected = ticket;
+      if (!tail.compare_exchange_strong(expected, ticket + 1)) {
+        return std::nullopt;
+      }
+      std::optional<T> rv(std::in_place);
+      std::memcpy(&*rv, buffer, sizeof(T));
+      return rv;
+    }
+
+    // The slot holds a newer ticket, so skip to the oldest item the
+    // producers cannot be overwriting
+    const auto oldest = head.load(std::memory_order_acquire) -
+                        ring.capacity();
+    auto expected = ticket;
+    if (static_cast<std::ptrdiff_t>(oldest - ticket) > 0 &&
+        tail.compare_exchange_strong(expected, oldest)) {
+      skipped.fetch_add(oldest - ticket, std::memory_order_relaxed);
+    }
+    return std::nullopt;
+  }
+
+  [[no_unique_address]] ring_index<dynamic_capacity, Traits::power_of_two>
+      ring;
+  std::unique_ptr<cell[]> cells;
+  [[no_unique_address]] typename Traits::wait_strategy waiter;
+
+  alignas(hw_inf_size) std::atomic_size_t head = 0;
+  alignas(hw_inf_size) std::atomic_size_t tail = 0;
+  alignas(hw_inf_size) std::atomic_uint64_t skipped = 0;
+};
+}  // namespace zeus
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "zeus/queue.hpp"
+#include "zeus/traits.hpp"
+#include "zeus/wait.hpp"
+
+namespace zeus {
+/// Lock-free multi-producer/multi-consumer queue with Levels fixed priority
+/// levels, each a zeus::queue. Level 0 has the highest priority. Consumers
+/// pop from the highest-priority non-empty level, found with a single
+/// countl_zero on an occupancy bitmap that producers set after enqueuing and
+/// consumers clear when they find a level empty. Items within a level are
+/// FIFO. Consumers that find every level empty wait through
+/// Traits::wait_strategy on a zeus::wait_epoch. Nothing is allocated after
+/// construction.
+///
+/// When StarvationLimit is not zero, every StarvationLimit-th pop prefers the
+/// levels at or below a rotating level instead of the highest one, so that
+/// every non-empty level is served at least once every
+/// StarvationLimit * Levels pops.
+template <regular_type T,
+          std::size_t Levels,
+          std::size_t StarvationLimit = 0,
+          typename Traits = queue_traits>
+class priority_queue {
+  static_assert(Levels >= 1 && Levels <= 64,
+                "priority_queue supports between 1 and 64 levels");
+
+  using level_type = zeus::queue<T, dynamic_capacity, Traits>;
+
+ public:
+  /// Constructs a new queue whose levels each hold level_capacity items.
+  explicit priority_queue(const std::size_t level_capacity) {
+    for (auto& ring : rings) {
+      ring = std::make_unique<level_type>(level_capacity);
+    }
+  }
+
+  priority_queue(const priority_queue&) = delete;
+  priority_queue& operator=(const priority_queue&) = delete;
+
+  /// Enqueues an item at the given priority level, blocking if the level is
+  /// full. Always returns true; the result matches zeus::queue.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool push(std::size_t level, P&& value) noexcept {
+    rings[level]->emplace(std::forward<P>(value));
+    mark(level);
+    events.notify();
+    return true;
+  }
+
+  /// Attempts to enqueue an item at the given priority level. Returns true on
+  /// success, false if the level is full.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool try_push(std::size_t level, P&& value) noexcept {
+    if (!rings[level]->try_emplace(std::forward<P>(value))) {
+      return false;
+    }
+    mark(level);
+    events.notify();
+    return true;
+  }
+
+  /// Removes and returns the highest-priority item, blocking while the queue
+  /// is empty.
+  T pop() noexcept {
+    while (true) {
+      if (auto rv = try_pop()) {
+        return std::move(*rv);
+      }
+      const auto key = events.prepare_wait();
+      if (auto rv = try_pop()) {
+        events.cancel_wait();
+        return std::move(*rv);
+      }
+      events.wait(key);
+    }
+  }
+
+  /// Attempts to remove and return the highest-priority item. Returns an
+  /// empty optional if every level is empty.
+  std::optional<T> try_pop() noexcept {
+    auto candidates = occupancy.load(std::memory_order_acquire);
+    auto preferred = candidates & rotation_mask();
+
+    while (candidates != 0) {
+      const auto level = static_cast<std::size_t>(
+          std::countl_zero(preferred != 0 ? preferred : candidates));
+      if (auto rv = rings[level]->try_pop()) {
+        return rv;
+      }
+
+      candidates &= ~bit(level);
+      preferred &= ~bit(level);
+
+      // Clear the level, then restore it if an item was enqueued meanwhile.
+      // Producers set the bit with a read-modify-write after enqueuing, so
+      // either their bit survives or their item is seen here.
+      occupancy.fetch_and(~bit(level), std::memory_order_acq_rel);
+      if (!rings[level]->empty()) {
+        occupancy.fetch_or(bit(level), std::memory_order_acq_rel);
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Returns the number of elements currently in the given level. The size
+  /// is not guaranteed to be accurate.
+  std::ptrdiff_t size(std::size_t level) const noexcept {
+    return rings[level]->size();
+  }
+
+  /// Returns true if every level is empty, otherwise false.
+  bool empty() const noexcept {
+    for (const auto& ring : rings) {
+      if (!ring->empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Returns the number of priority levels.
+  static constexpr std::size_t levels() noexcept { return Levels; }
+
+ private:
+  /// Returns the occupancy bit of level, counted from the most significant
+  /// bit so that countl_zero yields the highest-priority level.
+  static constexpr std::uint64_t bit(std::size_t level) noexcept {
+    return std::uint64_t{1} << (63 - level);
+  }
+
+  /// Marks level as possibly non-empty after an enqueue.
+  void mark(std::size_t level) noexcept {
+    occupancy.fetch_or(bit(level), std::memory_order_acq_rel);
+  }
+
+  /// Returns the levels the current pop prefers: every level, or on every
+  /// StarvationLimit-th pop those at or below a rotating level.
+  std::uint64_t rotation_mask() noexcept {
+    if constexpr (StarvationLimit == 0) {
+      return 0;
+    } else {
+      const auto count = served.fetch_add(1, std::memory_order_relaxed);
+      if (count % StarvationLimit != StarvationLimit - 1) {
+        return 0;
+      }
+      const auto start = (count / StarvationLimit) % Levels;
+      return ~std::uint64_t{0} >> start;
+    }
+  }
+
+  std::unique_ptr<level_type> rings[Levels];
+  alignas(hw_inf_size) std::atomic_uint64_t occupancy = 0;
+  alignas(hw_inf_size) std::atomic_size_t served = 0;
+  wait_epoch<typename Traits::wait_strategy> events;
+};
+}  // namespace zeus
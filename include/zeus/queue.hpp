@@ -1,182 +1,685 @@
 #pragma once
 
 #include <atomic>
+#include <algorithm>
+#include <bit>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <new>
 #include <optional>
 #include <type_traits>
 #include <utility>
 
+#include "zeus/latency.hpp"
+#include "zeus/layout.hpp"
+#include "zeus/ring_index.hpp"
 #include "zeus/slot.hpp"
+#include "zeus/stats.hpp"
+#include "zeus/traits.hpp"
+#include "zeus/wait.hpp"
 
 namespace zeus {
-template <typename T>
-concept regular_type = (std::is_nothrow_copy_assignable<T>::value ||
-                        std::is_nothrow_move_assignable<T>::value) &&
-                       std::is_nothrow_destructible<T>::value;
-
 /// Thread-safe, lock-free queue supporting multiple producers and consumers.
-template <regular_type T>
+/// The capacity is fixed at compile time when N is not zeus::dynamic_capacity.
+template <regular_type T,
+          std::size_t N = dynamic_capacity,
+          typename Traits = queue_traits>
 class queue {
+  using layout = typename Traits::layout;
+  using tracing_type = typename Traits::tracing;
+  using slot_type = zeus::slot<T, layout::alignment, tracing_type::enabled>;
+  using scrambler_type = std::conditional_t<layout::scramble,
+                                            index_scrambler,
+                                            identity_scrambler>;
+  using stats_type = typename Traits::stats;
+  using slot_allocator_traits = std::allocator_traits<
+      typename Traits::template allocator<slot_type>>;
+
+  /// True if the slots need no destruction, so that the destructor skips the
+  /// walk over the slot array.
+  static constexpr bool trivial_teardown =
+      std::is_trivially_destructible_v<slot_type> &&
+      !requires(typename slot_allocator_traits::allocator_type& a,
+                slot_type* p) { a.destroy(p); };
+
+  static_assert(!Traits::lazy_init ||
+                    requires {
+                      requires slot_allocator_traits::allocator_type::
+                          zero_filled;
+                    },
+                "lazy_init requires an allocator returning zero-filled memory");
+
+  static_assert(!layout::scramble || Traits::power_of_two ||
+                    (N != dynamic_capacity && std::has_single_bit(N)),
+                "scrambled_layout requires a power-of-two capacity");
+
+  static_assert(Traits::size_sample_interval == 0 ||
+                    std::has_single_bit(Traits::size_sample_interval),
+                "size_sample_interval must be zero or a power of two");
+
  public:
-  /// Constructs a new queue holding items of type T with the provided capacity
-  explicit queue(const std::size_t capacity) : max_capacity(capacity) {
-    // Add an extra slot to avoid incorrect data overlap in the final slot
-    slots = std::make_unique<zeus::slot<T>[]>(max_capacity + 1);
+  /// Type of the items held by the queue.
+  using value_type = T;
 
-    // Ensure that alignment is honored for over-aligned types
-    if (reinterpret_cast<std::size_t>(slots.get()) % alignof(zeus::slot<T>) !=
-        0) {
-      throw std::bad_alloc();
-    }
+  /// Allocator used for the slot array, rebound from Traits::allocator.
+  using allocator_type = typename slot_allocator_traits::allocator_type;
 
-    for (std::size_t i = 0; i < max_capacity; ++i) {
-      new (&slots[i]) zeus::slot<T>();
-    }
+  /// Constructs a new queue holding items of type T with the provided capacity
+  explicit queue(const std::size_t capacity,
+                 const allocator_type& allocator = allocator_type())
+    requires(N == dynamic_capacity)
+      : ring(capacity), alloc(allocator) {
+    allocate();
+  }
+
+  /// Constructs a new queue holding items of type T with a capacity of N
+  explicit queue(const allocator_type& allocator = allocator_type())
+    requires(N != dynamic_capacity)
+      : alloc(allocator) {
+    allocate();
   }
 
   /// Destroys the queue, releasing all resources.
   ~queue() noexcept {
-    for (std::size_t i = 0; i < max_capacity; ++i) {
-      slots[i].~slot();
+    if constexpr (!trivial_teardown) {
+      for (std::size_t i = 0; i < ring.capacity() + 1; ++i) {
+        slot_allocator_traits::destroy(alloc, std::to_address(slots + i));
+      }
     }
+    slot_allocator_traits::deallocate(alloc, slots, ring.capacity() + 1);
   }
 
   queue(const queue&) = delete;
   queue& operator=(const queue&) = delete;
 
   /// Enqueues an item by in-place construction, blocking if the queue is full.
+  /// Returns false without enqueuing if the queue is closed.
   template <typename... A>
     requires std::is_nothrow_constructible<T, A&&...>::value
-  void emplace(A&&... arguments) noexcept {
+  bool emplace(A&&... arguments) noexcept {
     const auto current_head = head.fetch_add(1);
-    zeus::slot<T>& slot = slots[get_idx(current_head)];
+    if (current_head & closed_flag) {
+      return false;
+    }
+    track_enqueue(current_head, current_head + 1);
+    prefetch<write_intent>(current_head);
+    slot_type& slot = get_slot(current_head);
+    const auto current_turn = get_current_turn(current_head) * 2;
 
     // Block while waiting for an open turn
-    do {
-    } while (get_current_turn(current_head) * 2 !=
-             slot.turn.load(std::memory_order_acquire));
+    wait_for(slot.turn,
+             [current_turn](auto turn) { return turn == current_turn; });
 
     slot.construct(std::forward<A>(arguments)...);
-    slot.turn.store(get_current_turn(current_head) * 2 + 1,
-                    std::memory_order_release);
+    stamp(slot, trace_now());
+    slot.turn.store(current_turn + 1, std::memory_order_release);
+    waiter.notify(slot.turn);
+    return true;
   }
 
   /// Attempts to enqueue an item by in-place construction. Returns true on
-  /// success, false if the queue is full.
+  /// success, false if the queue is full or closed.
   template <typename... A>
     requires std::is_nothrow_constructible<T, A&&...>::value
   bool try_emplace(A&&... arguments) noexcept {
-    auto current_head = head.load(std::memory_order_acquire);
-
-    while (true) {
-      zeus::slot<T>& slot = slots[get_idx(current_head)];
-      auto loaded_turn = slot.turn.load(std::memory_order_acquire);
-      auto current_turn = get_current_turn(current_head) * 2;
-
-      if (current_turn == loaded_turn) {
-        // If the slot is at the correct turn, try to claim it
-        if (head.compare_exchange_strong(current_head, current_head + 1)) {
-          // Construct the item in place and update the turn
-          slot.construct(std::forward<A>(arguments)...);
-          slot.turn.store(current_turn + 1, std::memory_order_release);
-          return true;
-        }
-      } else {
-        // If the slot turn does not match, the queue might be full
-        auto prev_head = current_head;
-        current_head = head.load(std::memory_order_acquire);
-
-        // If head hasn't changed, queue is full
-        if (current_head == prev_head) {
-          return false;
-        }
-      }
+    std::size_t current_head;
+    if (!try_claim(head, 0, current_head)) {
+      return false;
     }
+    track_enqueue(current_head, current_head + 1);
+    prefetch<write_intent>(current_head);
+
+    // Construct the item in place and update the turn
+    slot_type& slot = get_slot(current_head);
+    slot.construct(std::forward<A>(arguments)...);
+    stamp(slot, trace_now());
+    slot.turn.store(get_current_turn(current_head) * 2 + 1,
+                    std::memory_order_release);
+    waiter.notify(slot.turn);
+    return true;
   }
 
   /// Enqueues an item using move construction, blocking if the queue is full.
+  /// Returns false without enqueuing if the queue is closed.
   template <typename P>
     requires std::is_nothrow_constructible<T, P&&>::value
-  void push(P&& value) noexcept {
-    emplace(std::forward<P>(value));
+  bool push(P&& value) noexcept {
+    return emplace(std::forward<P>(value));
   }
 
   /// Enqueues an item using copy construction, blocking if the queue is full.
-  void push(const T& value) noexcept
+  /// Returns false without enqueuing if the queue is closed.
+  bool push(const T& value) noexcept
     requires std::is_nothrow_copy_constructible<T>::value
   {
     // Use the copy constructor to construct in-place
-    emplace(value);
+    return emplace(value);
   }
 
   /// Tries to enqueue an item using copy construction. Returns true on success,
-  /// false if the queue is full.
+  /// false if the queue is full or closed.
   bool try_push(const T& value) noexcept
     requires std::is_nothrow_copy_constructible<T>::value
   {
     return try_emplace(value);
   }
 
+  /// Attempts to enqueue an item until the deadline passes, waiting on the
+  /// slot at the head while the queue is full. Returns true on success, false
+  /// on timeout or if the queue is closed. No ticket is claimed unless the item is enqueued.
+  template <typename P, typename Clock, typename Duration>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool try_push_until(
+      P&& value,
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+    while (!try_emplace(std::forward<P>(value))) {
+      const auto current_head = head.load(std::memory_order_acquire);
+      if (current_head & closed_flag) {
+        return false;
+      }
+      const auto current_turn = get_current_turn(current_head) * 2;
+
+      // Wait for the consumer of the previous turn to free the slot
+      if (!waiter.wait_until(
+              get_slot(current_head).turn,
+              [current_turn](auto turn) { return turn != current_turn - 1; },
+              deadline)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Attempts to enqueue an item for at most timeout. Returns true on
+  /// success, false on timeout.
+  template <typename P, typename Rep, typename Period>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool try_push_for(P&& value,
+                    const std::chrono::duration<Rep, Period>& timeout) noexcept {
+    return try_push_until(std::forward<P>(value),
+                          std::chrono::steady_clock::now() + timeout);
+  }
+
+  /// Enqueues every item in [first, last) under a single claim of consecutive
+  /// tickets, blocking while the queue is full. Returns false without
+  /// enqueuing if the queue is closed.
+  template <std::forward_iterator I, std::sentinel_for<I> S>
+    requires std::is_nothrow_constructible<T, std::iter_reference_t<I>>::value
+  bool push_bulk(I first, S last) noexcept {
+    const auto count =
+        static_cast<std::size_t>(std::ranges::distance(first, last));
+    const auto first_head = head.fetch_add(count);
+    if (first_head & closed_flag) {
+      return false;
+    }
+    track_enqueue(first_head, first_head + count);
+    prefetch<write_intent>(first_head + count - 1);
+
+    const auto now = trace_now();
+    for (std::size_t i = 0; i < count; ++i, ++first) {
+      slot_type& slot = get_slot(first_head + i);
+      const auto current_turn = get_current_turn(first_head + i) * 2;
+
+      // Block while waiting for an open turn
+      wait_for(slot.turn,
+               [current_turn](auto turn) { return turn == current_turn; });
+
+      slot.construct(*first);
+      stamp(slot, now);
+      slot.turn.store(current_turn + 1, std::memory_order_release);
+      waiter.notify(slot.turn);
+    }
+    return true;
+  }
+
+  /// Attempts to enqueue the items in [first, last) under a single claim of
+  /// consecutive tickets. Returns the number of leading items enqueued, which
+  /// is less than requested when the queue fills up and zero once it is
+  /// closed.
+  template <std::forward_iterator I, std::sentinel_for<I> S>
+    requires std::is_nothrow_constructible<T, std::iter_reference_t<I>>::value
+  std::size_t try_push_bulk(I first, S last) noexcept {
+    const auto count =
+        static_cast<std::size_t>(std::ranges::distance(first, last));
+    auto current_head = head.load(std::memory_order_acquire);
+
+    while (count != 0 && (current_head & closed_flag) == 0) {
+      // Count the consecutive slots that are open for their turn
+      std::size_t open = 0;
+      while (open < count && is_at_turn(current_head + open, 0)) {
+        ++open;
+      }
+
+      if (open == 0) {
+        // If the first slot is not open, the queue might be full
+        auto prev_head = current_head;
+        current_head = head.load(std::memory_order_acquire);
+
+        // If head hasn't changed, queue is full
+        if (current_head == prev_head) {
+          counters.full_rejection();
+          return 0;
+        }
+      } else if (!head.compare_exchange_strong(current_head,
+                                               current_head + open)) {
+        counters.cas_failure();
+      } else {
+        track_enqueue(current_head, current_head + open);
+        prefetch<write_intent>(current_head + open - 1);
+
+        // Construct the items in place and update the turns
+        const auto now = trace_now();
+        for (std::size_t i = 0; i < open; ++i, ++first) {
+          slot_type& slot = get_slot(current_head + i);
+          slot.construct(*first);
+          stamp(slot, now);
+          slot.turn.store(get_current_turn(current_head + i) * 2 + 1,
+                          std::memory_order_release);
+          waiter.notify(slot.turn);
+        }
+        return open;
+      }
+    }
+
+    return 0;
+  }
+
   /// Removes and returns the front item from the queue, blocking if the queue
-  /// is full.
+  /// is empty. Has no way to report close(), so it blocks forever on a closed
+  /// and drained queue; use wait_pop() or pop(T&) on queues that may be
+  /// closed.
   T pop() noexcept
-    requires std::is_nothrow_copy_constructible<T>::value
+    requires std::is_nothrow_move_constructible<T>::value
   {
     const auto current_tail = tail.fetch_add(1);
-    zeus::slot<T>& slot = slots[get_idx(current_tail)];
+    track_dequeue(current_tail, current_tail + 1);
+    prefetch<read_intent>(current_tail);
+    slot_type& slot = get_slot(current_tail);
+    const auto expected_turn = get_current_turn(current_tail) * 2 + 1;
 
     // Block while waiting for an open turn
-    do {
-    } while (get_current_turn(current_tail) * 2 + 1 !=
-             slot.turn.load(std::memory_order_acquire));
+    wait_for(slot.turn,
+             [expected_turn](auto turn) { return turn == expected_turn; });
 
+    trace(slot, trace_now());
     T rv(slot.move());
     slot.destroy();
-    slot.turn.store(get_current_turn(current_tail) * 2 + 2,
-                    std::memory_order_release);
+    slot.turn.store(expected_turn + 1, std::memory_order_release);
+    waiter.notify(slot.turn);
+
+    return rv;
+  }
+
+  /// Removes the front item from the queue and move-assigns it to out,
+  /// blocking if the queue is empty. Avoids constructing a return value for
+  /// heavy types whose storage the caller reuses. Returns false, leaving out
+  /// untouched, once the queue is closed and every item enqueued before
+  /// close() has been removed.
+  bool pop(T& out) noexcept
+    requires std::is_nothrow_move_assignable<T>::value
+  {
+    const auto current_tail = tail.fetch_add(1);
+    track_dequeue(current_tail, current_tail + 1);
+    prefetch<read_intent>(current_tail);
+    slot_type& slot = get_slot(current_tail);
+    const auto expected_turn = get_current_turn(current_tail) * 2 + 1;
+    if (!wait_filled(slot, current_tail, expected_turn)) {
+      return false;
+    }
+
+    trace(slot, trace_now());
+    out = slot.move();
+    slot.destroy();
+    slot.turn.store(expected_turn + 1, std::memory_order_release);
+    waiter.notify(slot.turn);
+    return true;
+  }
 
+  /// Removes and returns the front item from the queue, blocking if the queue
+  /// is empty. Returns an empty optional once the queue is closed and every
+  /// item enqueued before close() has been removed.
+  std::optional<T> wait_pop() noexcept {
+    const auto current_tail = tail.fetch_add(1);
+    track_dequeue(current_tail, current_tail + 1);
+    prefetch<read_intent>(current_tail);
+    slot_type& slot = get_slot(current_tail);
+    const auto expected_turn = get_current_turn(current_tail) * 2 + 1;
+    if (!wait_filled(slot, current_tail, expected_turn)) {
+      return std::nullopt;
+    }
+
+    trace(slot, trace_now());
+    std::optional<T> rv(slot.move());
+    slot.destroy();
+    slot.turn.store(expected_turn + 1, std::memory_order_release);
+    waiter.notify(slot.turn);
     return rv;
   }
 
   /// Attempts to remove and return the front item from the queue. Returns the
   /// item if successful, or an empty optional if the queue is empty.
   std::optional<T> try_pop() noexcept {
-    auto current_tail = tail.load(std::memory_order_acquire);
+    std::size_t current_tail;
+    if (!try_claim(tail, 1, current_tail)) {
+      return std::nullopt;
+    }
+    track_dequeue(current_tail, current_tail + 1);
+    prefetch<read_intent>(current_tail);
 
+    slot_type& slot = get_slot(current_tail);
+    trace(slot, trace_now());
+    std::optional<T> rv(slot.move());
+    slot.destroy();
+    slot.turn.store(get_current_turn(current_tail) * 2 + 2,
+                    std::memory_order_release);
+    waiter.notify(slot.turn);
+    return rv;
+  }
+
+  /// Attempts to remove and return the front item until the deadline passes,
+  /// waiting on the slot at the tail while the queue is empty. Returns an
+  /// empty optional on timeout, or at once if the queue is closed and
+  /// drained. No ticket is claimed unless an item is removed.
+  template <typename Clock, typename Duration>
+  std::optional<T> try_pop_until(
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
     while (true) {
-      zeus::slot<T>& slot = slots[get_idx(current_tail)];
-      auto loaded_turn = slot.turn.load(std::memory_order_acquire);
-      auto expected_turn = get_current_turn(current_tail) * 2 + 1;
-
-      if (expected_turn == loaded_turn) {
-        // If the slot is at the expected turn, try to claim it
-        if (tail.compare_exchange_strong(current_tail, current_tail + 1)) {
-          T rv = slot.move();
-          slot.destroy();
-          slot.turn.store(get_current_turn(current_tail) * 2 + 2,
-                          std::memory_order_relaxed);
-          return rv;
-        }
-        // Loop continues with updated 't' if compare_exchange_strong fails
-      } else {
-        // If the slot turn does not match, the queue might be full
-        auto prev_tail = current_tail;
-        current_tail = tail.load(std::memory_order_acquire);
+      if (auto rv = try_pop()) {
+        return rv;
+      }
 
-        // If tail hasn't changed, queue is full
-        if (current_tail == prev_tail) {
-          return std::nullopt;
-        }
+      const auto current_tail = tail.load(std::memory_order_acquire);
+      if (current_tail >= final_head.load(std::memory_order_seq_cst) ||
+          Clock::now() >= deadline) {
+        // close() moves the turns of empty slots, which ends the wait below
+        // without filling them, so drained closed queues stop here
+        return std::nullopt;
+      }
+      const auto empty_turn = get_current_turn(current_tail) * 2;
+
+      // Wait for the producer of the current turn to fill the slot
+      if (!waiter.wait_until(
+              get_slot(current_tail).turn,
+              [empty_turn](auto turn) { return turn != empty_turn; },
+              deadline)) {
+        return std::nullopt;
       }
     }
   }
 
+  /// Attempts to remove and return the front item for at most timeout.
+  /// Returns an empty optional on timeout.
+  template <typename Rep, typename Period>
+  std::optional<T> try_pop_for(
+      const std::chrono::duration<Rep, Period>& timeout) noexcept {
+    return try_pop_until(std::chrono::steady_clock::now() + timeout);
+  }
+
+  /// Removes count items from the front of the queue under a single claim of
+  /// consecutive tickets and writes them to out, blocking while the queue is
+  /// empty. Returns the output iterator past the last item written.
+  template <std::output_iterator<T&&> O>
+  O pop_bulk(O out, std::size_t count) noexcept {
+    const auto first_tail = tail.fetch_add(count);
+    track_dequeue(first_tail, first_tail + count);
+    prefetch<read_intent>(first_tail + count - 1);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      slot_type& slot = get_slot(first_tail + i);
+      const auto expected_turn = get_current_turn(first_tail + i) * 2 + 1;
+
+      // Block while waiting for an open turn
+      wait_for(slot.turn,
+               [expected_turn](auto turn) { return turn == expected_turn; });
+
+      trace(slot, trace_now());
+      *out = slot.move();
+      ++out;
+      slot.destroy();
+      slot.turn.store(expected_turn + 1, std::memory_order_release);
+      waiter.notify(slot.turn);
+    }
+
+    return out;
+  }
+
+  /// Attempts to remove up to max items from the front of the queue under a
+  /// single claim of consecutive tickets and writes them to out. Returns the
+  /// number of items removed, which is zero if the queue is empty.
+  template <std::output_iterator<T&&> O>
+  std::size_t try_pop_bulk(O out, std::size_t max) noexcept {
+    std::size_t first_tail;
+    const auto ready = try_claim_ready(max, first_tail);
+
+    // Move the items out and release the slots to producers
+    const auto now = trace_now();
+    for (std::size_t i = 0; i < ready; ++i) {
+      slot_type& slot = get_slot(first_tail + i);
+      trace(slot, now);
+      *out = slot.move();
+      ++out;
+      release_slot(slot, first_tail + i);
+    }
+    return ready;
+  }
+
+  /// Attempts to remove the front item from the queue, invoking fn on it in
+  /// place before it is destroyed. Returns true if an item was consumed, false
+  /// if the queue is empty.
+  template <typename F>
+    requires std::is_nothrow_invocable<F&, T&>::value
+  bool consume_one(F&& fn) noexcept {
+    std::size_t current_tail;
+    if (!try_claim(tail, 1, current_tail)) {
+      return false;
+    }
+    track_dequeue(current_tail, current_tail + 1);
+    prefetch<read_intent>(current_tail);
+
+    slot_type& slot = get_slot(current_tail);
+    trace(slot, trace_now());
+    fn(slot.get());
+    release_slot(slot, current_tail);
+    return true;
+  }
+
+  /// Removes up to max items from the front of the queue, claiming each run of
+  /// consecutive ready tickets at once and invoking fn on every item in place
+  /// before it is destroyed. Stops when the queue is empty. Returns the number
+  /// of items consumed.
+  template <typename F>
+    requires std::is_nothrow_invocable<F&, T&>::value
+  std::size_t consume_all(
+      F&& fn,
+      std::size_t max = std::numeric_limits<std::size_t>::max()) noexcept {
+    std::size_t consumed = 0;
+    while (consumed < max) {
+      std::size_t first_tail;
+      const auto ready = try_claim_ready(max - consumed, first_tail);
+      if (ready == 0) {
+        break;
+      }
+
+      const auto now = trace_now();
+      for (std::size_t i = 0; i < ready; ++i) {
+        slot_type& slot = get_slot(first_tail + i);
+        trace(slot, now);
+        fn(slot.get());
+        release_slot(slot, first_tail + i);
+      }
+      consumed += ready;
+    }
+    return consumed;
+  }
+
+  /// Exclusive write access to a claimed slot. The item becomes visible to
+  /// consumers on commit, or when the reservation is destroyed.
+  class push_reservation {
+   public:
+    push_reservation(push_reservation&& other) noexcept
+        : owner(other.owner),
+          slot(std::exchange(other.slot, nullptr)),
+          turn(other.turn) {}
+
+    ~push_reservation() noexcept { commit(); }
+
+    push_reservation(const push_reservation&) = delete;
+    push_reservation& operator=(const push_reservation&) = delete;
+    push_reservation& operator=(push_reservation&&) = delete;
+
+    T& operator*() const noexcept { return slot->get(); }
+    T* operator->() const noexcept { return &slot->get(); }
+
+    /// Returns true if the reservation holds a slot.
+    explicit operator bool() const noexcept { return slot != nullptr; }
+
+    /// Publishes the item to consumers.
+    void commit() noexcept {
+      if (slot != nullptr) {
+        owner->stamp(*slot, owner->trace_now());
+        slot->turn.store(turn + 1, std::memory_order_release);
+        owner->waiter.notify(slot->turn);
+        slot = nullptr;
+      }
+    }
+
+   private:
+    friend class queue;
+
+    push_reservation(queue* owner, slot_type* slot, std::size_t turn) noexcept
+        : owner(owner), slot(slot), turn(turn) {}
+
+    queue* owner;
+    slot_type* slot;
+    std::size_t turn;
+  };
+
+  /// Exclusive read access to the item in a claimed slot. The item is
+  /// destroyed and the slot handed back to producers on release, or when the
+  /// reservation is destroyed.
+  class pop_reservation {
+   public:
+    pop_reservation(pop_reservation&& other) noexcept
+        : owner(other.owner),
+          slot(std::exchange(other.slot, nullptr)),
+          turn(other.turn) {}
+
+    ~pop_reservation() noexcept { release(); }
+
+    pop_reservation(const pop_reservation&) = delete;
+    pop_reservation& operator=(const pop_reservation&) = delete;
+    pop_reservation& operator=(pop_reservation&&) = delete;
+
+    T& operator*() const noexcept { return slot->get(); }
+    T* operator->() const noexcept { return &slot->get(); }
+
+    /// Destroys the item and releases the slot to producers.
+    void release() noexcept {
+      if (slot != nullptr) {
+        slot->destroy();
+        slot->turn.store(turn + 1, std::memory_order_release);
+        owner->waiter.notify(slot->turn);
+        slot = nullptr;
+      }
+    }
+
+   private:
+    friend class queue;
+
+    pop_reservation(queue* owner, slot_type* slot, std::size_t turn) noexcept
+        : owner(owner), slot(slot), turn(turn) {}
+
+    queue* owner;
+    slot_type* slot;
+    std::size_t turn;
+  };
+
+  /// Claims the next slot and constructs an item in place from the arguments,
+  /// blocking if the queue is full. The item is filled through the returned
+  /// reservation and published when it commits. The reservation is empty if
+  /// the queue is closed.
+  template <typename... A>
+    requires std::is_nothrow_constructible<T, A&&...>::value
+  push_reservation begin_push(A&&... arguments) noexcept {
+    const auto current_head = head.fetch_add(1);
+    if (current_head & closed_flag) {
+      return push_reservation(this, nullptr, 0);
+    }
+    track_enqueue(current_head, current_head + 1);
+    prefetch<write_intent>(current_head);
+    slot_type& slot = get_slot(current_head);
+    const auto current_turn = get_current_turn(current_head) * 2;
+
+    // Block while waiting for an open turn
+    wait_for(slot.turn,
+             [current_turn](auto turn) { return turn == current_turn; });
+
+    slot.construct(std::forward<A>(arguments)...);
+    return push_reservation(this, &slot, current_turn);
+  }
+
+  /// Attempts to claim the next slot and construct an item in place from the
+  /// arguments. Returns an empty optional if the queue is full or closed.
+  template <typename... A>
+    requires std::is_nothrow_constructible<T, A&&...>::value
+  std::optional<push_reservation> try_begin_push(A&&... arguments) noexcept {
+    std::size_t current_head;
+    if (!try_claim(head, 0, current_head)) {
+      return std::nullopt;
+    }
+    track_enqueue(current_head, current_head + 1);
+    prefetch<write_intent>(current_head);
+
+    slot_type& slot = get_slot(current_head);
+    slot.construct(std::forward<A>(arguments)...);
+    return push_reservation(this, &slot, get_current_turn(current_head) * 2);
+  }
+
+  /// Claims the front item in place, blocking if the queue is empty. The item
+  /// is accessed through the returned reservation and removed when it
+  /// releases.
+  pop_reservation begin_pop() noexcept {
+    const auto current_tail = tail.fetch_add(1);
+    track_dequeue(current_tail, current_tail + 1);
+    prefetch<read_intent>(current_tail);
+    slot_type& slot = get_slot(current_tail);
+    const auto expected_turn = get_current_turn(current_tail) * 2 + 1;
+
+    // Block while waiting for an open turn
+    wait_for(slot.turn,
+             [expected_turn](auto turn) { return turn == expected_turn; });
+
+    trace(slot, trace_now());
+    return pop_reservation(this, &slot, expected_turn);
+  }
+
+  /// Attempts to claim the front item in place. Returns an empty optional if
+  /// the queue is empty.
+  std::optional<pop_reservation> try_begin_pop() noexcept {
+    std::size_t current_tail;
+    if (!try_claim(tail, 1, current_tail)) {
+      return std::nullopt;
+    }
+    track_dequeue(current_tail, current_tail + 1);
+    prefetch<read_intent>(current_tail);
+
+    trace(get_slot(current_tail), trace_now());
+    return pop_reservation(this, &get_slot(current_tail),
+                           get_current_turn(current_tail) * 2 + 1);
+  }
+
   /// Returns the number of elements currently in the queue. The size may be
   /// negative when there is, at least, one reader waiting. The size is not
   /// guaranteed to be accurate.
   std::ptrdiff_t size() const noexcept {
-    auto difference = head.load(std::memory_order_relaxed) -
+    // Rejected producers still advance head once the queue is closed
+    auto difference = std::min(head.load(std::memory_order_relaxed) &
+                                   ~closed_flag,
+                               final_head.load(std::memory_order_relaxed)) -
                       tail.load(std::memory_order_relaxed);
     return static_cast<std::ptrdiff_t>(difference);
   }
@@ -184,21 +687,346 @@ class queue {
   /// Returns true if the queue is empty, otherwise false.
   bool empty() const noexcept { return size() <= 0; }
 
+  /// Returns the approximate number of items in the queue, between zero and
+  /// capacity(), from samples of head and tail published every
+  /// Traits::size_sample_interval tickets. Unlike size(), this only reads a
+  /// cache line that producers and consumers rarely write, so polling it
+  /// does not slow the queue down. The result may be off by up to twice the
+  /// interval.
+  std::size_t approx_size() const noexcept {
+    const auto difference =
+        Traits::size_sample_interval == 0
+            ? size()
+            : static_cast<std::ptrdiff_t>(
+                  sampled_head.load(std::memory_order_relaxed) -
+                  sampled_tail.load(std::memory_order_relaxed));
+    return static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(
+        difference, 0, static_cast<std::ptrdiff_t>(ring.capacity())));
+  }
+
+  /// Returns true if the slot at the head still held an item when checked,
+  /// meaning the queue was full. Reads head and the turn of one slot.
+  bool was_full() const noexcept {
+    const auto current_head = head.load(std::memory_order_relaxed);
+    return (current_head & closed_flag) == 0 && !is_at_turn(current_head, 0);
+  }
+
+  /// Returns true if the slot at the tail held no item when checked, meaning
+  /// the queue was empty. Reads tail and the turn of one slot.
+  bool was_empty() const noexcept {
+    return !is_at_turn(tail.load(std::memory_order_relaxed), 1);
+  }
+
+  /// Returns the number of items the queue can hold: the requested capacity,
+  /// or N, rounded up to a power of two when Traits::power_of_two is set.
+  /// Constant for the lifetime of the queue.
+  constexpr std::size_t capacity() const noexcept { return ring.capacity(); }
+
+  /// Closes the queue. Producers are rejected from then on, while consumers
+  /// keep removing the items already enqueued. Consumers blocked in
+  /// wait_pop() on a ticket that will never be filled are woken and return an
+  /// empty optional, and those blocked in pop(T&) return false. Consumers
+  /// blocked in pop() are not woken. Idempotent.
+  void close() noexcept {
+    const auto current_head =
+        head.fetch_or(closed_flag, std::memory_order_seq_cst);
+    if (current_head & closed_flag) {
+      return;
+    }
+    final_head.store(current_head, std::memory_order_seq_cst);
+
+    // Change the turn of every slot left empty for good so that parked
+    // consumers wake up. The read-modify-write on the other slots orders the
+    // close before their next turn, after which waiters see final_head.
+    for (auto i = current_head; i < current_head + ring.capacity(); ++i) {
+      auto& turn = get_slot(i).turn;
+      const auto empty_turn = get_current_turn(i) * 2;
+      auto current_turn = turn.fetch_add(0, std::memory_order_seq_cst);
+      if (current_turn == empty_turn) {
+        turn.compare_exchange_strong(current_turn, empty_turn + 2,
+                                     std::memory_order_seq_cst);
+      }
+      waiter.notify(turn);
+    }
+  }
+
+  /// Returns true if the queue has been closed, otherwise false.
+  bool closed() const noexcept {
+    return (head.load(std::memory_order_acquire) & closed_flag) != 0;
+  }
+
+  /// Returns the totals of the statistics collected by the queue.
+  queue_stats_snapshot snapshot() const noexcept
+    requires stats_type::enabled
+  {
+    return counters.snapshot();
+  }
+
+  /// Returns the histogram of the time items spent in the queue, in
+  /// trace_timestamp() ticks.
+  latency_snapshot residency() const noexcept
+    requires tracing_type::enabled
+  {
+    return tracer.snapshot();
+  }
+
+  /// Returns the wait strategy, through which a zeus::queue_set attaches to
+  /// the queue.
+  typename Traits::wait_strategy& wait_strategy() noexcept { return waiter; }
+
  private:
+  /// Allocates and initializes the slots backing the queue.
+  void allocate() {
+    // Add an extra slot to avoid incorrect data overlap in the final slot
+    slots = slot_allocator_traits::allocate(alloc, ring.capacity() + 1);
+
+    // Ensure that alignment is honored for over-aligned types
+    if (reinterpret_cast<std::size_t>(std::to_address(slots)) %
+            alignof(slot_type) !=
+        0) {
+      slot_allocator_traits::deallocate(alloc, slots, ring.capacity() + 1);
+      throw std::bad_alloc();
+    }
+
+    // Zero-filled memory already holds empty slots at turn zero
+    if constexpr (!Traits::lazy_init) {
+      for (std::size_t i = 0; i < ring.capacity() + 1; ++i) {
+        slot_allocator_traits::construct(alloc, std::to_address(slots + i));
+      }
+    }
+  }
+
   /// Returns the index in the queue corresponding to the global index i.
   constexpr std::size_t get_idx(std::size_t i) const noexcept {
-    return i % max_capacity;
+    return ring.get_idx(i);
   }
 
   /// Returns the current turn of the queue for the global index i.
   constexpr std::size_t get_current_turn(std::size_t i) const noexcept {
-    return i / max_capacity;
+    return ring.get_current_turn(i);
+  }
+
+  /// Returns the slot holding the global index i.
+  slot_type& get_slot(std::size_t i) noexcept {
+    return slots[scramble(get_idx(i))];
+  }
+
+  /// Returns the slot holding the global index i.
+  const slot_type& get_slot(std::size_t i) const noexcept {
+    return slots[scramble(get_idx(i))];
+  }
+
+  /// Flag set in head once the queue is closed.
+  static constexpr std::size_t closed_flag = std::size_t{1}
+                                             << (sizeof(std::size_t) * 8 - 1);
+
+  /// Values of the rw argument of __builtin_prefetch.
+  static constexpr int read_intent = 0;
+  static constexpr int write_intent = 1;
+
+  /// Prefetches the slot Traits::prefetch_distance tickets after ticket i,
+  /// which the next operations on the same side of the queue will touch.
+  template <int Intent>
+  void prefetch([[maybe_unused]] std::size_t i) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (Traits::prefetch_distance != 0) {
+      __builtin_prefetch(&get_slot(i + Traits::prefetch_distance), Intent, 3);
+    }
+#endif
+  }
+
+  /// Returns true if the slot holding the global index i is empty (parity 0)
+  /// or full (parity 1) for the current turn of i.
+  bool is_at_turn(std::size_t i, std::size_t parity) const noexcept {
+    return get_slot(i).turn.load(std::memory_order_acquire) ==
+           get_current_turn(i) * 2 + parity;
+  }
+
+  /// Blocks until ready returns true for the turn of a slot, recording the
+  /// wait when statistics are enabled.
+  template <typename P>
+  void wait_for(std::atomic_size_t& turn, P&& ready) noexcept {
+    if constexpr (stats_type::enabled) {
+      if (ready(turn.load(std::memory_order_acquire))) {
+        return;
+      }
+
+      std::uint64_t spins = 0;
+      const auto start = std::chrono::steady_clock::now();
+      waiter.wait(turn, [&ready, &spins](auto current) {
+        ++spins;
+        return ready(current);
+      });
+      counters.wait(spins, static_cast<std::uint64_t>(
+                               std::chrono::duration_cast<
+                                   std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count()));
+    } else {
+      waiter.wait(turn, std::forward<P>(ready));
+    }
+  }
+
+  /// Publishes a sample of head once producers claimed [first_head,
+  /// next_head), and records the occupancy of the queue when statistics are
+  /// enabled.
+  void track_enqueue(std::size_t first_head, std::size_t next_head) noexcept {
+    sample(sampled_head, first_head, next_head);
+    if constexpr (stats_type::enabled) {
+      const auto items = static_cast<std::ptrdiff_t>(
+          next_head - tail.load(std::memory_order_relaxed));
+      counters.occupancy(static_cast<std::uint64_t>(std::max<std::ptrdiff_t>(
+          items, 0)));
+    }
+  }
+
+  /// Publishes a sample of tail once consumers claimed [first_tail,
+  /// next_tail).
+  void track_dequeue(std::size_t first_tail, std::size_t next_tail) noexcept {
+    sample(sampled_tail, first_tail, next_tail);
+  }
+
+  /// Stores next in sampled if [first, next) ends past a multiple of
+  /// Traits::size_sample_interval.
+  static void sample([[maybe_unused]] std::atomic_size_t& sampled,
+                     [[maybe_unused]] std::size_t first,
+                     [[maybe_unused]] std::size_t next) noexcept {
+    if constexpr (Traits::size_sample_interval != 0) {
+      constexpr auto shift = std::countr_zero(Traits::size_sample_interval);
+      if ((first >> shift) != (next >> shift)) {
+        sampled.store(next, std::memory_order_relaxed);
+      }
+    }
+  }
+
+
+  /// Claims up to max consecutive tickets at the front of tail whose slots
+  /// hold an item, storing the first in first_tail. Returns the number of
+  /// tickets claimed, which is zero if the queue is empty.
+  std::size_t try_claim_ready(std::size_t max,
+                              std::size_t& first_tail) noexcept {
+    first_tail = tail.load(std::memory_order_acquire);
+
+    while (max != 0) {
+      // Count the consecutive slots that hold an item for their turn
+      std::size_t ready = 0;
+      while (ready < max && is_at_turn(first_tail + ready, 1)) {
+        ++ready;
+      }
+
+      if (ready == 0) {
+        // If the first slot holds no item, the queue might be empty
+        auto prev_tail = first_tail;
+        first_tail = tail.load(std::memory_order_acquire);
+
+        // If tail hasn't changed, queue is empty
+        if (first_tail == prev_tail) {
+          counters.empty_rejection();
+          return 0;
+        }
+      } else if (!tail.compare_exchange_strong(first_tail,
+                                               first_tail + ready)) {
+        counters.cas_failure();
+      } else {
+        track_dequeue(first_tail, first_tail + ready);
+        prefetch<read_intent>(first_tail + ready - 1);
+        return ready;
+      }
+    }
+
+    return 0;
+  }
+
+  /// Returns the current trace timestamp, or zero when tracing is disabled.
+  std::uint64_t trace_now() const noexcept {
+    if constexpr (tracing_type::enabled) {
+      return trace_timestamp();
+    } else {
+      return 0;
+    }
   }
 
-  const std::size_t max_capacity;
-  std::unique_ptr<zeus::slot<T>[]> slots;
+  /// Stores the enqueue timestamp now in a slot when tracing is enabled.
+  void stamp(slot_type& slot, [[maybe_unused]] std::uint64_t now) noexcept {
+    if constexpr (tracing_type::enabled) {
+      slot.stamp = now;
+    }
+  }
+
+  /// Records the time the item in a slot spent in the queue until now when
+  /// tracing is enabled.
+  void trace(const slot_type& slot,
+             [[maybe_unused]] std::uint64_t now) noexcept {
+    if constexpr (tracing_type::enabled) {
+      tracer.record(now > slot.stamp ? now - slot.stamp : 0);
+    }
+  }
+
+  /// Blocks until the slot claimed for ticket current_tail holds its item, or
+  /// until the queue is closed before the ticket was enqueued. Returns false
+  /// in the latter case, where the ticket will never be filled.
+  bool wait_filled(slot_type& slot,
+                   std::size_t current_tail,
+                   std::size_t expected_turn) noexcept {
+    wait_for(slot.turn, [this, current_tail, expected_turn](auto turn) {
+      return turn == expected_turn ||
+             current_tail >= final_head.load(std::memory_order_seq_cst);
+    });
+    // Producers never fill the ticket once the queue closed before it
+    return slot.turn.load(std::memory_order_acquire) == expected_turn;
+  }
+
+  /// Destroys the item in the claimed slot holding ticket i and hands the
+  /// slot back to producers.
+  void release_slot(slot_type& slot, std::size_t i) noexcept {
+    slot.destroy();
+    slot.turn.store(get_current_turn(i) * 2 + 2, std::memory_order_release);
+    waiter.notify(slot.turn);
+  }
+
+  /// Claims the ticket at the front of counter if its slot holds the given
+  /// parity for the ticket's turn, storing it in ticket. Returns false if the
+  /// queue is full (parity 0), empty (parity 1) or closed.
+  bool try_claim(std::atomic_size_t& counter,
+                 std::size_t parity,
+                 std::size_t& ticket) noexcept {
+    if (claim_ticket(
+            counter, ticket,
+            [this, parity](auto i) { return is_at_turn(i, parity); },
+            // Only head carries the flag, once the queue is closed
+            [](auto i) { return (i & closed_flag) != 0; },
+            [this] { counters.cas_failure(); })) {
+      return true;
+    }
+    if ((ticket & closed_flag) == 0) {
+      if (parity == 0) {
+        counters.full_rejection();
+      } else {
+        counters.empty_rejection();
+      }
+    }
+    return false;
+  }
+
+
+  [[no_unique_address]] ring_index<N, Traits::power_of_two> ring;
+  [[no_unique_address]] scrambler_type scramble{ring.capacity(),
+                                                sizeof(slot_type)};
+  [[no_unique_address]] allocator_type alloc;
+  typename slot_allocator_traits::pointer slots;
+  [[no_unique_address]] typename Traits::wait_strategy waiter;
+  [[no_unique_address]] stats_type counters;
+  [[no_unique_address]] tracing_type tracer;
 
   alignas(hw_inf_size) std::atomic_size_t head;
   alignas(hw_inf_size) std::atomic_size_t tail;
+
+  // Samples of head and tail read by approx_size()
+  alignas(hw_inf_size) std::atomic_size_t sampled_head = 0;
+  std::atomic_size_t sampled_tail = 0;
+
+  // Head at the time of close(): tickets from it on are never enqueued
+  alignas(hw_inf_size) std::atomic_size_t final_head =
+      std::numeric_limits<std::size_t>::max();
 };
 }  // namespace zeus
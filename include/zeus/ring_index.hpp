@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <utility>
+
+namespace zeus {
+/// Capacity value selecting a queue whose capacity is provided at runtime.
+inline constexpr std::size_t dynamic_capacity = 0;
+
+/// Maps global tickets onto ring indices and turns for a compile-time
+/// capacity. Both operations fold into constants, so power-of-two capacities
+/// compile down to a mask and a shift.
+template <std::size_t N, bool PowerOfTwo>
+class ring_index {
+ public:
+  static constexpr std::size_t max_capacity = PowerOfTwo ? std::bit_ceil(N) : N;
+
+  /// Returns the number of slots in the ring.
+  static constexpr std::size_t capacity() noexcept { return max_capacity; }
+
+  /// Returns the index in the ring corresponding to the global index i.
+  static constexpr std::size_t get_idx(std::size_t i) noexcept {
+    return i % max_capacity;
+  }
+
+  /// Returns the current turn of the ring for the global index i.
+  static constexpr std::size_t get_current_turn(std::size_t i) noexcept {
+    return i / max_capacity;
+  }
+};
+
+/// Maps global tickets onto ring indices and turns for a runtime capacity.
+/// Each mapping costs a hardware divide.
+template <>
+class ring_index<dynamic_capacity, false> {
+ public:
+  explicit constexpr ring_index(std::size_t capacity) noexcept
+      : max_capacity(capacity) {}
+
+  /// Returns the number of slots in the ring.
+  constexpr std::size_t capacity() const noexcept { return max_capacity; }
+
+  /// Returns the index in the ring corresponding to the global index i.
+  constexpr std::size_t get_idx(std::size_t i) const noexcept {
+    return i % max_capacity;
+  }
+
+  /// Returns the current turn of the ring for the global index i.
+  constexpr std::size_t get_current_turn(std::size_t i) const noexcept {
+    return i / max_capacity;
+  }
+
+ private:
+  std::size_t max_capacity;
+};
+
+/// Maps global tickets onto ring indices and turns for a runtime capacity
+/// rounded up to the next power of two, replacing the divides with a mask and
+/// a shift.
+template <>
+class ring_index<dynamic_capacity, true> {
+ public:
+  explicit constexpr ring_index(std::size_t capacity) noexcept
+      : mask(std::bit_ceil(capacity) - 1),
+        shift(std::countr_zero(std::bit_ceil(capacity))) {}
+
+  /// Returns the number of slots in the ring.
+  constexpr std::size_t capacity() const noexcept { return mask + 1; }
+
+  /// Returns the index in the ring corresponding to the global index i.
+  constexpr std::size_t get_idx(std::size_t i) const noexcept {
+    return i & mask;
+  }
+
+  /// Returns the current turn of the ring for the global index i.
+  constexpr std::size_t get_current_turn(std::size_t i) const noexcept {
+    return i >> shift;
+  }
+
+ private:
+  std::size_t mask;
+  int shift;
+};
+
+/// Claims the ticket at the front of counter, storing it in ticket, once
+/// at_turn(ticket) reports that its slot holds the turn the caller expects.
+/// Shared by the turn-based rings so that they run one copy of the protocol.
+/// Returns false if stopped(ticket) holds, or if the slot is not at the turn
+/// and counter has not moved, meaning the ring is full or empty.
+/// on_cas_failure() is invoked for every lost compare-exchange.
+template <typename AtTurn, typename Stopped, typename OnCasFailure>
+bool claim_ticket(std::atomic_size_t& counter,
+                  std::size_t& ticket,
+                  AtTurn&& at_turn,
+                  Stopped&& stopped,
+                  OnCasFailure&& on_cas_failure) noexcept {
+  ticket = counter.load(std::memory_order_acquire);
+
+  while (true) {
+    if (stopped(ticket)) {
+      return false;
+    } else if (at_turn(ticket)) {
+      // If the slot is at the expected turn, try to claim it
+      if (counter.compare_exchange_strong(ticket, ticket + 1)) {
+        return true;
+      }
+      on_cas_failure();
+    } else {
+      // If the counter hasn't changed, the ring is full or empty
+      const auto prev_ticket = ticket;
+      ticket = counter.load(std::memory_order_acquire);
+      if (ticket == prev_ticket) {
+        return false;
+      }
+    }
+  }
+}
+
+/// Claims the ticket at the front of counter once at_turn(ticket) holds.
+template <typename AtTurn>
+bool claim_ticket(std::atomic_size_t& counter,
+                  std::size_t& ticket,
+                  AtTurn&& at_turn) noexcept {
+  return claim_ticket(
+      counter, ticket, std::forward<AtTurn>(at_turn),
+      [](std::size_t) { return false; }, [] {});
+}
+}  // namespace zeus
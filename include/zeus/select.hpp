@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include "zeus/slot.hpp"
+#include "zeus/wait.hpp"
+
+namespace zeus {
+/// Wake-up state shared by the queues of a zeus::queue_set. Consumers park on
+/// a zeus::wait_epoch that notify() bumps. When an eventfd is enabled,
+/// notify() also makes it readable once per arm(), so that the set can be
+/// waited on from epoll. While nobody waits and the eventfd is not armed,
+/// notify() costs a fence and two reads.
+class select_events {
+ public:
+  /// Constructs the wake-up state, with an eventfd if event_fd is set. Throws
+  /// std::system_error if the eventfd cannot be created.
+  explicit select_events(bool event_fd = false) {
+    if (event_fd) {
+#if defined(__linux__)
+      fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+      }
+#else
+      throw std::system_error(
+          std::make_error_code(std::errc::function_not_supported), "eventfd");
+#endif
+    }
+  }
+
+  ~select_events() noexcept {
+#if defined(__linux__)
+    if (fd >= 0) {
+      ::close(fd);
+    }
+#endif
+  }
+
+  select_events(const select_events&) = delete;
+  select_events& operator=(const select_events&) = delete;
+
+  /// Returns the epoch that consumers of the set wait on.
+  wait_epoch<park_wait<>>& epoch() noexcept { return waiters; }
+
+  /// Wakes every waiter and signals the eventfd if it is armed. Called after
+  /// an item is published.
+  void notify() noexcept {
+    // The fence in wait_epoch::notify() also orders the read of armed below
+    // against the fence in arm()
+    waiters.notify();
+#if defined(__linux__)
+#if defined(__SANITIZE_THREAD__)
+    // ThreadSanitizer does not model fences, so order through armed
+    if (!armed.exchange(false, std::memory_order_acq_rel)) {
+      return;
+    }
+#else
+    if (!armed.load(std::memory_order_relaxed) ||
+        !armed.exchange(false, std::memory_order_acq_rel)) {
+      return;
+    }
+#endif
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(fd, &one, sizeof(one));
+#endif
+  }
+
+  /// Clears the eventfd and arms it, so that the next notify() makes it
+  /// readable. The caller must check its queues again after arming.
+  void arm() noexcept {
+#if defined(__linux__)
+    std::uint64_t value;
+    [[maybe_unused]] const auto drained = ::read(fd, &value, sizeof(value));
+#endif
+#if defined(__SANITIZE_THREAD__)
+    armed.exchange(true, std::memory_order_acq_rel);
+#else
+    armed.store(true, std::memory_order_relaxed);
+    // Pairs with the fence in notify(): either the producer sees the flag or
+    // the caller's next check of its queues sees the item
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+  }
+
+  /// Returns the eventfd, or -1 if it is not enabled.
+  int native_handle() const noexcept { return fd; }
+
+ private:
+  wait_epoch<park_wait<>> waiters;
+  alignas(hw_inf_size) std::atomic_bool armed = false;
+  int fd = -1;
+};
+
+/// Wait strategy for queues that belong to a zeus::queue_set. Waits like Base
+/// and additionally notifies the event count of the set whenever a producer
+/// publishes an item. Consumer wake-ups are filtered out by the turn parity,
+/// so only producers pay for the check.
+template <typename Base = spin_wait>
+class select_wait : public Base {
+ public:
+  /// Wakes threads waiting on word after it has been updated, and the set
+  /// the queue belongs to if word now holds an item.
+  void notify(std::atomic_size_t& word) noexcept {
+    Base::notify(word);
+    if ((word.load(std::memory_order_relaxed) & 1) != 0) {
+      if (select_events* events = listener.load(std::memory_order_acquire)) {
+        events->notify();
+      }
+    }
+  }
+
+  /// Attaches the queue to events, or detaches it if events is null.
+  void listen(select_events* events) noexcept {
+    listener.store(events, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<select_events*> listener = nullptr;
+};
+
+/// Item removed from a zeus::queue_set, along with the position of the queue
+/// it came from.
+template <typename T>
+struct selected {
+  std::size_t index;
+  T value;
+};
+
+/// Set of queues that one or more consumers wait on together, returning the
+/// first ready item. The queues must use zeus::select_wait and belong to at
+/// most one set. Queues are scanned round-robin from the one after the last
+/// hit, so a busy queue cannot starve the others. Consumers that find every
+/// queue empty park on a shared zeus::wait_epoch instead of polling.
+///
+/// Producers notify the set through a pointer held by each queue, so the set
+/// must only be destroyed once producers have stopped pushing.
+template <typename Q>
+  requires requires(Q& queue, select_events* events) {
+    queue.wait_strategy().listen(events);
+  }
+class queue_set {
+ public:
+  using value_type = typename Q::value_type;
+
+  /// Constructs a set over queues, with an eventfd if event_fd is set. Throws
+  /// std::system_error if the eventfd cannot be created.
+  explicit queue_set(std::initializer_list<Q*> queues, bool event_fd = false)
+      : queues(queues), events(event_fd) {
+    for (Q* queue : this->queues) {
+      queue->wait_strategy().listen(&events);
+    }
+  }
+
+  /// Detaches the queues from the set.
+  ~queue_set() noexcept {
+    for (Q* queue : queues) {
+      queue->wait_strategy().listen(nullptr);
+    }
+  }
+
+  queue_set(const queue_set&) = delete;
+  queue_set& operator=(const queue_set&) = delete;
+
+  /// Removes and returns the first ready item, blocking while every queue is
+  /// empty.
+  selected<value_type> pop() noexcept {
+    while (true) {
+      if (auto rv = try_pop()) {
+        return std::move(*rv);
+      }
+      const auto key = events.epoch().prepare_wait();
+      if (auto rv = try_pop()) {
+        events.epoch().cancel_wait();
+        return std::move(*rv);
+      }
+      events.epoch().wait(key);
+    }
+  }
+
+  /// Attempts to remove and return the first ready item. Returns an empty
+  /// optional if every queue is empty.
+  std::optional<selected<value_type>> try_pop() noexcept {
+    const auto first = next.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < queues.size(); ++i) {
+      const auto index = (first + i) % queues.size();
+      if (auto item = queues[index]->try_pop()) {
+        next.store(index + 1, std::memory_order_relaxed);
+        return selected<value_type>{index, std::move(*item)};
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Attempts to remove and return the first ready item until the deadline
+  /// passes. Returns an empty optional on timeout.
+  template <typename Clock, typename Duration>
+  std::optional<selected<value_type>> try_pop_until(
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+    while (true) {
+      if (auto rv = try_pop()) {
+        return rv;
+      }
+      const auto key = events.epoch().prepare_wait();
+      if (auto rv = try_pop()) {
+        events.epoch().cancel_wait();
+        return rv;
+      }
+      if (!events.epoch().wait_until(key, deadline)) {
+        return try_pop();
+      }
+    }
+  }
+
+  /// Attempts to remove and return the first ready item for at most timeout.
+  /// Returns an empty optional on timeout.
+  template <typename Rep, typename Period>
+  std::optional<selected<value_type>> try_pop_for(
+      const std::chrono::duration<Rep, Period>& timeout) noexcept {
+    return try_pop_until(std::chrono::steady_clock::now() + timeout);
+  }
+
+  /// Arms the eventfd so that it becomes readable once an item is pushed.
+  /// Returns false if an item is already ready, in which case the caller
+  /// should drain the set and arm it again before returning to epoll.
+  bool arm() noexcept {
+    events.arm();
+    return std::all_of(queues.begin(), queues.end(),
+                       [](Q* queue) { return queue->was_empty(); });
+  }
+
+  /// Returns the eventfd to register with epoll for EPOLLIN, or -1 if the set
+  /// was constructed without one.
+  int native_handle() const noexcept { return events.native_handle(); }
+
+  /// Returns the number of queues in the set.
+  std::size_t size() const noexcept { return queues.size(); }
+
+ private:
+  std::vector<Q*> queues;
+  select_events events;
+  std::atomic_size_t next = 0;
+};
+}  // namespace zeus
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "zeus/queue.hpp"
+#include "zeus/traits.hpp"
+#include "zeus/wait.hpp"
+
+namespace zeus {
+/// Returns the index of the calling thread among the threads that used a
+/// zeus::sharded_queue, assigned on first use.
+inline std::size_t lane_thread_index() noexcept {
+  static std::atomic_size_t next_thread = 0;
+  thread_local const std::size_t index =
+      next_thread.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+/// Multi-producer/multi-consumer queue split into independent lanes, each a
+/// zeus::queue with its own head and tail, so that threads working on
+/// different lanes never contend. Threads are numbered in the order they
+/// first use a sharded queue, and each thread's home lane is its number
+/// modulo the number of lanes. Producers enqueue to their home lane, and
+/// consumers dequeue from their home lane first, then from the other lanes in
+/// round-robin order. Consumers that find every lane empty wait through
+/// Traits::wait_strategy on a zeus::wait_epoch.
+///
+/// Ordering is per producer only: items enqueued by one thread to one lane
+/// are dequeued in the order they were enqueued, but items from different
+/// producers are not ordered with respect to each other.
+template <regular_type T, typename Traits = queue_traits>
+class sharded_queue {
+  using lane_type = zeus::queue<T, dynamic_capacity, Traits>;
+
+ public:
+  /// Constructs a new queue of lanes lanes, each holding lane_capacity items.
+  /// Throws std::invalid_argument if lanes is zero.
+  sharded_queue(const std::size_t lanes, const std::size_t lane_capacity) {
+    if (lanes == 0) {
+      throw std::invalid_argument("sharded_queue requires at least one lane");
+    }
+    shards.reserve(lanes);
+    for (std::size_t i = 0; i < lanes; ++i) {
+      shards.push_back(std::make_unique<lane_type>(lane_capacity));
+    }
+  }
+
+  sharded_queue(const sharded_queue&) = delete;
+  sharded_queue& operator=(const sharded_queue&) = delete;
+
+  /// Enqueues an item to the home lane of the calling thread, blocking if the
+  /// lane is full. Always returns true; the result matches zeus::queue.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool push(P&& value) noexcept {
+    return push_to(home_lane(), std::forward<P>(value));
+  }
+
+  /// Attempts to enqueue an item to the home lane of the calling thread.
+  /// Returns true on success, false if the lane is full. Other lanes are not
+  /// tried, which would break per-producer ordering.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool try_push(P&& value) noexcept {
+    return try_push_to(home_lane(), std::forward<P>(value));
+  }
+
+  /// Enqueues an item to the given lane, blocking if the lane is full. Lets
+  /// callers map lanes to NUMA nodes or core groups themselves. Always returns
+  /// true.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool push_to(std::size_t lane, P&& value) noexcept {
+    shards[lane]->emplace(std::forward<P>(value));
+    events.notify();
+    return true;
+  }
+
+  /// Attempts to enqueue an item to the given lane. Returns true on success,
+  /// false if the lane is full.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool try_push_to(std::size_t lane, P&& value) noexcept {
+    if (!shards[lane]->try_emplace(std::forward<P>(value))) {
+      return false;
+    }
+    events.notify();
+    return true;
+  }
+
+  /// Removes and returns an item, blocking if every lane is empty.
+  T pop() noexcept {
+    while (true) {
+      if (auto rv = try_pop()) {
+        return std::move(*rv);
+      }
+      const auto key = events.prepare_wait();
+      if (auto rv = try_pop()) {
+        events.cancel_wait();
+        return std::move(*rv);
+      }
+      events.wait(key);
+    }
+  }
+
+  /// Attempts to remove and return an item, trying the home lane of the
+  /// calling thread first and then every other lane once. Returns an empty
+  /// optional if no lane held an item.
+  std::optional<T> try_pop() noexcept {
+    const auto home = home_lane();
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+      const auto lane = home + i < shards.size() ? home + i
+                                                 : home + i - shards.size();
+      if (auto rv = shards[lane]->try_pop()) {
+        return rv;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Returns the home lane of the calling thread: its thread index modulo
+  /// the number of lanes. Stable for the lifetime of the thread, which keeps
+  /// its items in order, and free of per-queue state.
+  std::size_t home_lane() const noexcept {
+    return lane_thread_index() % shards.size();
+  }
+
+
+  /// Returns the number of lanes.
+  std::size_t lanes() const noexcept { return shards.size(); }
+
+  /// Returns the number of elements currently in the queue. The size is not
+  /// guaranteed to be accurate.
+  std::ptrdiff_t size() const noexcept {
+    std::ptrdiff_t total = 0;
+    for (const auto& lane : shards) {
+      total += std::max<std::ptrdiff_t>(lane->size(), 0);
+    }
+    return total;
+  }
+
+  /// Returns true if the queue is empty, otherwise false.
+  bool empty() const noexcept { return size() <= 0; }
+
+  /// Returns the number of items the queue can hold across every lane.
+  std::size_t capacity() const noexcept {
+    return shards.size() * shards.front()->capacity();
+  }
+
+ private:
+  std::vector<std::unique_ptr<lane_type>> shards;
+  wait_epoch<typename Traits::wait_strategy> events;
+};
+}  // namespace zeus
@@ -0,0 +1,370 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "zeus/ring_index.hpp"
+#include "zeus/slot.hpp"
+#include "zeus/wait.hpp"
+
+namespace zeus {
+/// Control block at the start of a zeus::shm_queue mapping. Every process
+/// attached to the queue shares the head and tail counters stored here.
+struct shm_header {
+  /// Identifies an initialized mapping. Written last by the creator, so it
+  /// doubles as the ready word: zero until every other field is set.
+  static constexpr std::uint64_t expected_magic = 0x7a6575732d73686dULL;
+  /// Incremented whenever the layout of the mapping changes.
+  static constexpr std::uint32_t layout_version = 1;
+
+  std::atomic_uint64_t magic = 0;
+  std::uint32_t version = layout_version;
+  std::uint32_t slot_size = 0;
+  std::uint64_t capacity = 0;
+
+  alignas(hw_inf_size) std::atomic_size_t head = 0;
+  alignas(hw_inf_size) std::atomic_size_t tail = 0;
+};
+
+/// Lock-free queue supporting multiple producers and consumers in different
+/// processes. The control block and the slot array live in a shared memory
+/// mapping, created or attached by name with shm_open or through a file
+/// descriptor such as one returned by memfd_create. Items are copied
+/// bytewise between address spaces, so T must be trivially copyable.
+template <typename T>
+  requires std::is_trivially_copyable_v<T>
+class shm_queue {
+  using slot_type = zeus::slot<T>;
+
+ public:
+  /// Creates a new named queue with the provided capacity. Throws
+  /// std::system_error if the capacity is zero, the name already exists or
+  /// the mapping fails, in which case a name created here is removed again.
+  static shm_queue create(const std::string& name, std::size_t capacity) {
+    check_capacity(capacity);
+    const int fd =
+        ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "shm_open");
+    }
+    try {
+      return shm_queue(fd, capacity);
+    } catch (...) {
+      ::shm_unlink(name.c_str());
+      throw;
+    }
+  }
+
+  /// Attaches to an existing named queue. Throws std::system_error if the
+  /// name does not exist or was created for a different item layout, and
+  /// with std::errc::resource_unavailable_try_again if its creator has not
+  /// finished initializing it yet, in which case the caller may retry.
+  static shm_queue open(const std::string& name) {
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "shm_open");
+    }
+    return shm_queue(fd);
+  }
+
+#if defined(__linux__)
+  /// Creates a new anonymous queue backed by memfd_create. Other processes
+  /// attach through the descriptor returned by fd(), for example after fork or
+  /// when passed over a Unix socket. Throws std::system_error if the
+  /// capacity is zero or the mapping fails.
+  static shm_queue create_anonymous(std::size_t capacity) {
+    check_capacity(capacity);
+    const int fd = ::memfd_create("zeus::shm_queue", MFD_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "memfd_create");
+    }
+    return shm_queue(fd, capacity);
+  }
+#endif
+
+  /// Attaches to the queue stored in the shared memory object fd. The
+  /// descriptor is duplicated, so the caller keeps ownership of fd.
+  static shm_queue attach(int fd) {
+    const int own = ::dup(fd);
+    if (own < 0) {
+      throw std::system_error(errno, std::generic_category(), "dup");
+    }
+    return shm_queue(own);
+  }
+
+  /// Removes a named queue. Attached processes keep their mappings.
+  static void unlink(const std::string& name) noexcept {
+    ::shm_unlink(name.c_str());
+  }
+
+  shm_queue(shm_queue&& other) noexcept
+      : descriptor(std::exchange(other.descriptor, -1)),
+        mapping(std::exchange(other.mapping, nullptr)),
+        bytes(std::exchange(other.bytes, 0)),
+        header(std::exchange(other.header, nullptr)),
+        slots(std::exchange(other.slots, nullptr)),
+        ring(other.ring) {}
+
+  /// Unmaps the queue. The shared memory object outlives the mapping.
+  ~shm_queue() noexcept {
+    if (mapping != nullptr) {
+      ::munmap(mapping, bytes);
+    }
+    if (descriptor >= 0) {
+      ::close(descriptor);
+    }
+  }
+
+  shm_queue(const shm_queue&) = delete;
+  shm_queue& operator=(const shm_queue&) = delete;
+  shm_queue& operator=(shm_queue&&) = delete;
+
+  /// Enqueues an item by in-place construction, blocking if the queue is full.
+  template <typename... A>
+    requires std::is_nothrow_constructible<T, A&&...>::value
+  void emplace(A&&... arguments) noexcept {
+    const auto current_head = header->head.fetch_add(1);
+    slot_type& slot = get_slot(current_head);
+    const auto current_turn = get_current_turn(current_head) * 2;
+
+    // Block while waiting for an open turn
+    waiter.wait(slot.turn,
+                [current_turn](auto turn) { return turn == current_turn; });
+
+    slot.construct(std::forward<A>(arguments)...);
+    slot.turn.store(current_turn + 1, std::memory_order_release);
+  }
+
+  /// Attempts to enqueue an item by in-place construction. Returns true on
+  /// success, false if the queue is full.
+  template <typename... A>
+    requires std::is_nothrow_constructible<T, A&&...>::value
+  bool try_emplace(A&&... arguments) noexcept {
+    std::size_t current_head;
+    if (!claim_ticket(header->head, current_head,
+                      [this](auto i) { return is_at_turn(i, 0); })) {
+      return false;
+    }
+
+    slot_type& slot = get_slot(current_head);
+    slot.construct(std::forward<A>(arguments)...);
+    slot.turn.store(get_current_turn(current_head) * 2 + 1,
+                    std::memory_order_release);
+    return true;
+  }
+
+  /// Enqueues a copy of value, blocking if the queue is full.
+  void push(const T& value) noexcept { emplace(value); }
+
+  /// Tries to enqueue a copy of value. Returns true on success, false if the
+  /// queue is full.
+  bool try_push(const T& value) noexcept { return try_emplace(value); }
+
+  /// Removes and returns the front item from the queue, blocking if the queue
+  /// is empty.
+  T pop() noexcept {
+    const auto current_tail = header->tail.fetch_add(1);
+    slot_type& slot = get_slot(current_tail);
+    const auto expected_turn = get_current_turn(current_tail) * 2 + 1;
+
+    // Block while waiting for an open turn
+    waiter.wait(slot.turn,
+                [expected_turn](auto turn) { return turn == expected_turn; });
+
+    T rv(slot.move());
+    slot.turn.store(expected_turn + 1, std::memory_order_release);
+    return rv;
+  }
+
+  /// Attempts to remove and return the front item from the queue. Returns the
+  /// item if successful, or an empty optional if the queue is empty.
+  std::optional<T> try_pop() noexcept {
+    std::size_t current_tail;
+    if (!claim_ticket(header->tail, current_tail,
+                      [this](auto i) { return is_at_turn(i, 1); })) {
+      return std::nullopt;
+    }
+
+    slot_type& slot = get_slot(current_tail);
+    std::optional<T> rv(slot.move());
+    slot.turn.store(get_current_turn(current_tail) * 2 + 2,
+                    std::memory_order_release);
+    return rv;
+  }
+
+  /// Returns the number of elements currently in the queue. The size may be
+  /// negative when there is, at least, one reader waiting. The size is not
+  /// guaranteed to be accurate.
+  std::ptrdiff_t size() const noexcept {
+    auto difference = header->head.load(std::memory_order_relaxed) -
+                      header->tail.load(std::memory_order_relaxed);
+    return static_cast<std::ptrdiff_t>(difference);
+  }
+
+  /// Returns true if the queue is empty, otherwise false.
+  bool empty() const noexcept { return size() <= 0; }
+
+  /// Returns the number of slots in the queue.
+  std::size_t capacity() const noexcept { return ring.capacity(); }
+
+  /// Returns the file descriptor of the shared memory object.
+  int fd() const noexcept { return descriptor; }
+
+ private:
+  /// Sizes, maps and initializes a freshly created shared memory object.
+  shm_queue(int fd, std::size_t capacity)
+      : descriptor(fd), bytes(mapping_size(capacity)), ring(capacity) {
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+      fail("ftruncate");
+    }
+    map();
+
+    header = new (mapping) shm_header();
+    header->slot_size = sizeof(slot_type);
+    header->capacity = capacity;
+    slots = reinterpret_cast<slot_type*>(static_cast<std::byte*>(mapping) +
+                                         slots_offset());
+    for (std::size_t i = 0; i < capacity; ++i) {
+      new (slots + i) slot_type();
+    }
+
+    // Publish the initialized mapping to attaching processes
+    header->magic.store(shm_header::expected_magic, std::memory_order_release);
+  }
+
+  /// Maps and validates an existing shared memory object.
+  explicit shm_queue(int fd) : descriptor(fd), ring(1) {
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+      fail("fstat");
+    }
+    bytes = static_cast<std::size_t>(status.st_size);
+    if (bytes == 0) {
+      // The creator has not sized the object yet
+      fail_not_ready();
+    }
+    if (bytes < slots_offset()) {
+      fail_layout();
+    }
+    map();
+
+    header = std::launder(reinterpret_cast<shm_header*>(mapping));
+    const auto magic = header->magic.load(std::memory_order_acquire);
+    if (magic == 0) {
+      fail_not_ready();
+    }
+    if (magic != shm_header::expected_magic ||
+        header->version != shm_header::layout_version ||
+        header->slot_size != sizeof(slot_type) || header->capacity == 0 ||
+        mapping_size(header->capacity) > bytes) {
+      fail_layout();
+    }
+
+    ring = ring_index<dynamic_capacity, false>(header->capacity);
+    slots = std::launder(reinterpret_cast<slot_type*>(
+        static_cast<std::byte*>(mapping) + slots_offset()));
+  }
+
+  /// Maps bytes of the shared memory object into the address space.
+  void map() {
+    void* memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          descriptor, 0);
+    if (memory == MAP_FAILED) {
+      fail("mmap");
+    }
+    mapping = memory;
+  }
+
+  /// Releases the descriptor and throws the current errno as a system_error.
+  [[noreturn]] void fail(const char* what) {
+    const int error = errno;
+    release();
+    throw std::system_error(error, std::generic_category(), what);
+  }
+
+  /// Releases the mapping and throws for an incompatible shared memory object.
+  [[noreturn]] void fail_layout() {
+    release();
+    throw std::system_error(std::make_error_code(std::errc::invalid_argument),
+                            "shm_queue layout mismatch");
+  }
+
+  /// Releases the mapping and throws for a shared memory object whose creator
+  /// has not published it yet.
+  [[noreturn]] void fail_not_ready() {
+    release();
+    throw std::system_error(
+        std::make_error_code(std::errc::resource_unavailable_try_again),
+        "shm_queue not initialized");
+  }
+
+  /// Unmaps the mapping and closes the descriptor before a failed
+  /// construction unwinds, since the destructor does not run then.
+  void release() noexcept {
+    if (mapping != nullptr) {
+      ::munmap(mapping, bytes);
+      mapping = nullptr;
+    }
+    ::close(descriptor);
+    descriptor = -1;
+  }
+
+  /// Returns the offset of the slot array from the start of the mapping.
+  static constexpr std::size_t slots_offset() noexcept {
+    return (sizeof(shm_header) + alignof(slot_type) - 1) / alignof(slot_type) *
+           alignof(slot_type);
+  }
+
+  /// Throws for a capacity that open() would reject as a layout mismatch.
+  static void check_capacity(std::size_t capacity) {
+    if (capacity == 0) {
+      throw std::system_error(
+          std::make_error_code(std::errc::invalid_argument),
+          "shm_queue capacity must be positive");
+    }
+  }
+
+  /// Returns the size of a mapping holding capacity slots.
+  static constexpr std::size_t mapping_size(std::size_t capacity) noexcept {
+    return slots_offset() + capacity * sizeof(slot_type);
+  }
+
+  /// Returns the current turn of the queue for the global index i.
+  std::size_t get_current_turn(std::size_t i) const noexcept {
+    return ring.get_current_turn(i);
+  }
+
+  /// Returns the slot holding the global index i.
+  slot_type& get_slot(std::size_t i) const noexcept {
+    return slots[ring.get_idx(i)];
+  }
+
+  /// Returns true if the slot holding the global index i is empty (parity 0)
+  /// or full (parity 1) for the current turn of i.
+  bool is_at_turn(std::size_t i, std::size_t parity) const noexcept {
+    return get_slot(i).turn.load(std::memory_order_acquire) ==
+           get_current_turn(i) * 2 + parity;
+  }
+
+  int descriptor = -1;
+  void* mapping = nullptr;
+  std::size_t bytes = 0;
+  shm_header* header = nullptr;
+  slot_type* slots = nullptr;
+  ring_index<dynamic_capacity, false> ring;
+  [[no_unique_address]] spin_wait waiter;
+};
+}  // namespace zeus
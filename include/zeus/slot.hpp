@@ -2,6 +2,12 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace zeus {
 #if defined(__cpp_lib_hardware_interference_size) && !defined(__APPLE__)
@@ -11,17 +17,35 @@ static constexpr size_t hw_inf_size =
 static constexpr size_t hw_inf_size = 64;
 #endif
 
+template <typename T>
+concept regular_type = (std::is_nothrow_copy_assignable<T>::value ||
+                        std::is_nothrow_move_assignable<T>::value) &&
+                       std::is_nothrow_destructible<T>::value;
+
 template <typename T, typename... Args>
 concept arg_regular_type = std::is_nothrow_constructible<T, Args...>::value &&
                            std::is_nothrow_destructible<T>::value;
 
+/// Empty stand-in for the enqueue timestamp of unstamped slots.
+struct no_stamp {};
+
 /// Represents a slot in zeus::queue message queue, managing the lifecycle of
-/// contained objects.
-template <arg_regular_type T>
+/// contained objects. The turn counter is aligned to Align bytes, which pads
+/// each slot to a full cache line by default. Trivially copyable items are
+/// copied with memcpy, and trivially destructible items are never destroyed,
+/// which also makes the slot itself trivially destructible. Stamped slots
+/// keep an enqueue timestamp next to the turn, in space the padding would
+/// otherwise waste.
+template <arg_regular_type T,
+          std::size_t Align = hw_inf_size,
+          bool Stamped = false>
 class slot {
  public:
   /// Destructor ensuring proper destruction of the contained object if
   /// necessary.
+  ~slot() noexcept
+    requires std::is_trivially_destructible_v<T>
+  = default;
   ~slot() noexcept {
     if (turn % 2 != 0) {
       destroy();
@@ -32,19 +56,34 @@ class slot {
   /// no-throw construction.
   template <typename... A>
   void construct(A&&... arguments) noexcept {
-    new (&storage) T(std::forward<A>(arguments)...);
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof...(A) == 1 &&
+                  (std::is_same_v<std::remove_cvref_t<A>, T> && ...)) {
+      // Copying the bytes implicitly creates the object in the storage
+      std::memcpy(storage, std::addressof(arguments)..., sizeof(T));
+    } else {
+      new (storage) T(std::forward<A>(arguments)...);
+    }
   }
 
   /// Destroys the contained object of type T, ensuring it's no-throw
   /// destructible.
-  void destroy() noexcept { reinterpret_cast<T*>(&storage)->~T(); }
+  void destroy() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      get().~T();
+    }
+  }
 
   /// Moves the contained object out of the slot, returning a rvalue reference
   /// to it.
-  T&& move() noexcept { return reinterpret_cast<T&&>(storage); }
+  T&& move() noexcept { return std::move(get()); }
+
+  /// Returns a reference to the contained object.
+  T& get() noexcept { return *std::launder(reinterpret_cast<T*>(storage)); }
 
  public:
-  alignas(hw_inf_size) std::atomic_size_t turn = 0;
-  typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  alignas(Align) std::atomic_size_t turn = 0;
+  [[no_unique_address]] std::conditional_t<Stamped, std::uint64_t, no_stamp>
+      stamp;
+  alignas(T) std::byte storage[sizeof(T)];
 };
 }  // namespace zeus
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "zeus/slot.hpp"
+#include "zeus/wait.hpp"
+
+namespace zeus {
+/// Thread-safe, lock-free queue supporting a single producer and a single
+/// consumer. Offers the same interface as zeus::queue, but publishes items
+/// with plain loads and stores of the head and tail indices instead of
+/// read-modify-write operations and per-slot turns.
+template <regular_type T>
+class spsc_queue {
+ public:
+  /// Constructs a new queue holding items of type T with the provided capacity
+  explicit spsc_queue(const std::size_t capacity)
+      : max_capacity(capacity),
+        // Add an extra slot to distinguish a full queue from an empty one
+        cells(std::make_unique<cell[]>(capacity + 1)) {}
+
+  /// Destroys the queue, releasing all resources.
+  ~spsc_queue() noexcept {
+    auto current_tail = tail.load(std::memory_order_relaxed);
+    const auto current_head = head.load(std::memory_order_relaxed);
+    while (current_tail != current_head) {
+      get(current_tail)->~T();
+      current_tail = next(current_tail);
+    }
+  }
+
+  spsc_queue(const spsc_queue&) = delete;
+  spsc_queue& operator=(const spsc_queue&) = delete;
+
+  /// Enqueues an item by in-place construction, blocking if the queue is full.
+  /// Always returns true, since the queue cannot be closed; the result
+  /// matches zeus::queue.
+  template <typename... A>
+    requires std::is_nothrow_constructible<T, A&&...>::value
+  bool emplace(A&&... arguments) noexcept {
+    const auto current_head = head.load(std::memory_order_relaxed);
+    const auto next_head = next(current_head);
+
+    // Block while waiting for the consumer to free a cell
+    while (next_head == tail_cache) {
+      tail_cache = tail.load(std::memory_order_acquire);
+      if (next_head == tail_cache) {
+        cpu_relax();
+      }
+    }
+
+    new (cells[current_head].storage) T(std::forward<A>(arguments)...);
+    head.store(next_head, std::memory_order_release);
+    return true;
+  }
+
+  /// Attempts to enqueue an item by in-place construction. Returns true on
+  /// success, false if the queue is full.
+  template <typename... A>
+    requires std::is_nothrow_constructible<T, A&&...>::value
+  bool try_emplace(A&&... arguments) noexcept {
+    const auto current_head = head.load(std::memory_order_relaxed);
+    const auto next_head = next(current_head);
+
+    // Only refresh the cached tail when the queue looks full
+    if (next_head == tail_cache) {
+      tail_cache = tail.load(std::memory_order_acquire);
+      if (next_head == tail_cache) {
+        return false;
+      }
+    }
+
+    new (cells[current_head].storage) T(std::forward<A>(arguments)...);
+    head.store(next_head, std::memory_order_release);
+    return true;
+  }
+
+  /// Enqueues an item using move construction, blocking if the queue is full.
+  /// Always returns true.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool push(P&& value) noexcept {
+    return emplace(std::forward<P>(value));
+  }
+
+  /// Enqueues an item using copy construction, blocking if the queue is full.
+  /// Always returns true.
+  bool push(const T& value) noexcept
+    requires std::is_nothrow_copy_constructible<T>::value
+  {
+    return emplace(value);
+  }
+
+  /// Tries to enqueue an item using copy construction. Returns true on success,
+  /// false if the queue is full.
+  bool try_push(const T& value) noexcept
+    requires std::is_nothrow_copy_constructible<T>::value
+  {
+    return try_emplace(value);
+  }
+
+  /// Removes and returns the front item from the queue, blocking if the queue
+  /// is empty.
+  T pop() noexcept
+    requires std::is_nothrow_move_constructible<T>::value
+  {
+    const auto current_tail = tail.load(std::memory_order_relaxed);
+
+    // Block while waiting for the producer to publish an item
+    while (current_tail == head_cache) {
+      head_cache = head.load(std::memory_order_acquire);
+      if (current_tail == head_cache) {
+        cpu_relax();
+      }
+    }
+
+    T rv(std::move(*get(current_tail)));
+    get(current_tail)->~T();
+    tail.store(next(current_tail), std::memory_order_release);
+
+    return rv;
+  }
+
+  /// Removes the front item from the queue and move-assigns it to out,
+  /// blocking if the queue is empty. Always returns true.
+  bool pop(T& out) noexcept
+    requires std::is_nothrow_move_assignable<T>::value
+  {
+    const auto current_tail = tail.load(std::memory_order_relaxed);
+
+    // Block while waiting for the producer to publish an item
+    while (current_tail == head_cache) {
+      head_cache = head.load(std::memory_order_acquire);
+      if (current_tail == head_cache) {
+        cpu_relax();
+      }
+    }
+
+    out = std::move(*get(current_tail));
+    get(current_tail)->~T();
+    tail.store(next(current_tail), std::memory_order_release);
+    return true;
+  }
+
+  /// Attempts to remove and return the front item from the queue. Returns the
+  /// item if successful, or an empty optional if the queue is empty.
+  std::optional<T> try_pop() noexcept {
+    const auto current_tail = tail.load(std::memory_order_relaxed);
+
+    // Only refresh the cached head when the queue looks empty
+    if (current_tail == head_cache) {
+      head_cache = head.load(std::memory_order_acquire);
+      if (current_tail == head_cache) {
+        return std::nullopt;
+      }
+    }
+
+    std::optional<T> rv(std::move(*get(current_tail)));
+    get(current_tail)->~T();
+    tail.store(next(current_tail), std::memory_order_release);
+
+    return rv;
+  }
+
+  /// Returns the number of elements currently in the queue. The size is not
+  /// guaranteed to be accurate while the queue is in use.
+  std::ptrdiff_t size() const noexcept {
+    auto difference =
+        static_cast<std::ptrdiff_t>(head.load(std::memory_order_acquire)) -
+        static_cast<std::ptrdiff_t>(tail.load(std::memory_order_acquire));
+    if (difference < 0) {
+      difference += static_cast<std::ptrdiff_t>(max_capacity + 1);
+    }
+    return difference;
+  }
+
+  /// Returns true if the queue is empty, otherwise false.
+  bool empty() const noexcept { return size() <= 0; }
+
+ private:
+  /// Uninitialized storage for a single item.
+  struct cell {
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  /// Returns the index following the cell index i.
+  constexpr std::size_t next(std::size_t i) const noexcept {
+    return i == max_capacity ? 0 : i + 1;
+  }
+
+  /// Returns a pointer to the item stored in the cell index i.
+  T* get(std::size_t i) noexcept {
+    return std::launder(reinterpret_cast<T*>(cells[i].storage));
+  }
+
+  const std::size_t max_capacity;
+  std::unique_ptr<cell[]> cells;
+
+  // Producer-owned line: the published head and the last tail it observed
+  alignas(hw_inf_size) std::atomic_size_t head = 0;
+  std::size_t tail_cache = 0;
+
+  // Consumer-owned line: the published tail and the last head it observed
+  alignas(hw_inf_size) std::atomic_size_t tail = 0;
+  std::size_t head_cache = 0;
+};
+}  // namespace zeus
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "zeus/slot.hpp"
+
+namespace zeus {
+/// Point-in-time totals of the counters collected by zeus::sharded_stats.
+struct queue_stats_snapshot {
+  /// Failed head or tail CAS attempts in non-blocking operations.
+  std::uint64_t cas_failures = 0;
+  /// Non-blocking enqueues rejected because the queue was full.
+  std::uint64_t full_rejections = 0;
+  /// Non-blocking dequeues rejected because the queue was empty.
+  std::uint64_t empty_rejections = 0;
+  /// Blocking operations that had to wait for their slot turn.
+  std::uint64_t waits = 0;
+  /// Turn checks performed by the wait strategy while waiting.
+  std::uint64_t wait_spins = 0;
+  /// Total time spent waiting, in nanoseconds.
+  std::uint64_t wait_nanoseconds = 0;
+  /// Largest number of items observed in the queue after an enqueue.
+  std::uint64_t high_water_mark = 0;
+};
+
+/// Statistics policy that collects nothing. Every hook is empty, so the
+/// instrumentation compiles out of the queue.
+struct no_stats {
+  static constexpr bool enabled = false;
+
+  void cas_failure() noexcept {}
+  void full_rejection() noexcept {}
+  void empty_rejection() noexcept {}
+  void wait(std::uint64_t, std::uint64_t) noexcept {}
+  void occupancy(std::uint64_t) noexcept {}
+};
+
+/// Statistics policy that counts contention, rejections and waits. Threads
+/// are assigned round-robin to Shards counter blocks, each on its own cache
+/// line, so that up to Shards threads never contend on a counter.
+template <std::size_t Shards = 16>
+class sharded_stats {
+ public:
+  static constexpr bool enabled = true;
+
+  /// Counts a failed head or tail CAS.
+  void cas_failure() noexcept {
+    local().cas_failures.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Counts an enqueue rejected by a full queue.
+  void full_rejection() noexcept {
+    local().full_rejections.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Counts a dequeue rejected by an empty queue.
+  void empty_rejection() noexcept {
+    local().empty_rejections.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Counts a blocking wait of spins turn checks lasting nanoseconds.
+  void wait(std::uint64_t spins, std::uint64_t nanoseconds) noexcept {
+    shard& counters = local();
+    counters.waits.fetch_add(1, std::memory_order_relaxed);
+    counters.wait_spins.fetch_add(spins, std::memory_order_relaxed);
+    counters.wait_nanoseconds.fetch_add(nanoseconds,
+                                        std::memory_order_relaxed);
+  }
+
+  /// Records the number of items observed in the queue after an enqueue.
+  void occupancy(std::uint64_t items) noexcept {
+    auto& high = local().high_water_mark;
+    auto current = high.load(std::memory_order_relaxed);
+    while (items > current &&
+           !high.compare_exchange_weak(current, items,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  /// Returns the totals of every counter. Counters are read individually, so
+  /// the snapshot is not atomic with respect to concurrent operations.
+  queue_stats_snapshot snapshot() const noexcept {
+    queue_stats_snapshot totals;
+    for (const shard& counters : shards) {
+      totals.cas_failures +=
+          counters.cas_failures.load(std::memory_order_relaxed);
+      totals.full_rejections +=
+          counters.full_rejections.load(std::memory_order_relaxed);
+      totals.empty_rejections +=
+          counters.empty_rejections.load(std::memory_order_relaxed);
+      totals.waits += counters.waits.load(std::memory_order_relaxed);
+      totals.wait_spins += counters.wait_spins.load(std::memory_order_relaxed);
+      totals.wait_nanoseconds +=
+          counters.wait_nanoseconds.load(std::memory_order_relaxed);
+      totals.high_water_mark =
+          std::max(totals.high_water_mark,
+                   counters.high_water_mark.load(std::memory_order_relaxed));
+    }
+    return totals;
+  }
+
+ private:
+  /// Counters updated by the threads assigned to one shard.
+  struct alignas(hw_inf_size) shard {
+    std::atomic_uint64_t cas_failures = 0;
+    std::atomic_uint64_t full_rejections = 0;
+    std::atomic_uint64_t empty_rejections = 0;
+    std::atomic_uint64_t waits = 0;
+    std::atomic_uint64_t wait_spins = 0;
+    std::atomic_uint64_t wait_nanoseconds = 0;
+    std::atomic_uint64_t high_water_mark = 0;
+  };
+
+  /// Returns the shard assigned to the calling thread.
+  shard& local() noexcept {
+    static std::atomic_size_t next_thread = 0;
+    thread_local const std::size_t thread =
+        next_thread.fetch_add(1, std::memory_order_relaxed);
+    return shards[thread % Shards];
+  }
+
+  shard shards[Shards];
+};
+}  // namespace zeus
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "zeus/queue.hpp"
+#include "zeus/slot.hpp"
+#include "zeus/wait.hpp"
+#include "zeus/work_stealing_deque.hpp"
+
+namespace zeus {
+/// Move-only nullary callable. Callables of at most inline_size bytes that are
+/// nothrow move constructible are stored inline; larger ones are allocated on
+/// the heap. Invoking a task whose callable throws calls std::terminate.
+class task {
+ public:
+  /// Size of the inline storage, chosen so that a task fills a cache line.
+  static constexpr std::size_t inline_size = 48;
+
+  /// Constructs an empty task.
+  task() noexcept = default;
+
+  /// Constructs a task holding a decayed copy of fn. Throws std::bad_alloc if
+  /// fn is stored on the heap and the allocation fails.
+  template <typename F>
+    requires(!std::is_same_v<std::remove_cvref_t<F>, task>) &&
+            std::is_invocable_r_v<void, std::decay_t<F>&>
+  task(F&& fn) : ops(&operations_for<std::decay_t<F>>) {
+    using callable = std::decay_t<F>;
+    if constexpr (stored_inline<callable>) {
+      new (&storage) callable(std::forward<F>(fn));
+    } else {
+      new (&storage) callable*(new callable(std::forward<F>(fn)));
+    }
+  }
+
+  task(task&& other) noexcept : ops(std::exchange(other.ops, nullptr)) {
+    if (ops != nullptr) {
+      ops->relocate(&other.storage, &storage);
+    }
+  }
+
+  task& operator=(task&& other) noexcept {
+    if (this != &other) {
+      reset();
+      ops = std::exchange(other.ops, nullptr);
+      if (ops != nullptr) {
+        ops->relocate(&other.storage, &storage);
+      }
+    }
+    return *this;
+  }
+
+  ~task() noexcept { reset(); }
+
+  /// Returns true if the task holds a callable.
+  explicit operator bool() const noexcept { return ops != nullptr; }
+
+  /// Invokes the callable. The task must not be empty.
+  void operator()() noexcept { ops->invoke(&storage); }
+
+ private:
+  /// Type-erased operations on the callable held in the storage.
+  struct operations {
+    void (*invoke)(void* storage) noexcept;
+    void (*relocate)(void* from, void* to) noexcept;
+    void (*destroy)(void* storage) noexcept;
+  };
+
+  template <typename F>
+  static constexpr bool stored_inline =
+      sizeof(F) <= inline_size && alignof(F) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<F>;
+
+  template <typename F>
+  static F& target(void* storage) noexcept {
+    if constexpr (stored_inline<F>) {
+      return *std::launder(static_cast<F*>(storage));
+    } else {
+      return **std::launder(static_cast<F**>(storage));
+    }
+  }
+
+  template <typename F>
+  static constexpr operations operations_for = {
+      [](void* storage) noexcept { target<F>(storage)(); },
+      [](void* from, void* to) noexcept {
+        if constexpr (stored_inline<F>) {
+          new (to) F(std::move(target<F>(from)));
+          target<F>(from).~F();
+        } else {
+          new (to) F*(&target<F>(from));
+        }
+      },
+      [](void* storage) noexcept {
+        if constexpr (stored_inline<F>) {
+          target<F>(storage).~F();
+        } else {
+          delete &target<F>(storage);
+        }
+      }};
+
+  /// Destroys the callable, leaving the task empty.
+  void reset() noexcept {
+    if (ops != nullptr) {
+      std::exchange(ops, nullptr)->destroy(&storage);
+    }
+  }
+
+  const operations* ops = nullptr;
+  alignas(std::max_align_t) std::byte storage[inline_size];
+};
+
+/// Work-stealing thread pool. Each worker owns a Chase-Lev deque that tasks
+/// submitted from the worker are pushed to and popped from in LIFO order, for
+/// cache locality. Tasks submitted from other threads, and tasks that overflow
+/// a full deque, go through a shared zeus::queue used as the injection queue.
+/// Idle workers steal from the top of randomly chosen deques, then park until
+/// new work is submitted. Tasks must not throw.
+class thread_pool {
+ public:
+  /// Capacity of the deque of each worker.
+  static constexpr std::size_t deque_capacity = 256;
+
+  /// Steal rounds an idle worker performs before parking.
+  static constexpr std::size_t spin_rounds = 64;
+
+  /// Starts threads workers with an injection queue of the provided capacity.
+  explicit thread_pool(
+      std::size_t threads = std::max(1u, std::thread::hardware_concurrency()),
+      std::size_t injection_capacity = 1024)
+      : injection(injection_capacity) {
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+      workers.push_back(std::make_unique<worker>());
+    }
+    for (std::size_t i = 0; i < threads; ++i) {
+      workers[i]->thread = std::thread([this, i] { run(i); });
+    }
+  }
+
+  /// Runs every submitted task, including tasks they submit, then joins the
+  /// workers. Tasks must not be submitted from other threads once the
+  /// destructor has started.
+  ~thread_pool() noexcept {
+    stopping.store(true, std::memory_order_release);
+    epoch.fetch_add(1, std::memory_order_acq_rel);
+    epoch.notify_all();
+    for (auto& w : workers) {
+      w->thread.join();
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  /// Schedules fn for execution. From a worker of this pool, the task is
+  /// pushed to the worker's deque, or run inline if both the deque and the
+  /// injection queue are full. From any other thread, the task is enqueued on
+  /// the injection queue, blocking while it is full.
+  template <typename F>
+  void submit(F&& fn) {
+    task work(std::forward<F>(fn));
+
+    if (current.pool == this) {
+      if (workers[current.index]->deque.try_push(std::move(work))) {
+        // The owner runs the task anyway, so a missed wake-up only costs
+        // parallelism and the cheap check suffices
+        if (sleepers.load(std::memory_order_relaxed) != 0) {
+          wake();
+        }
+        return;
+      }
+      if (!injection.try_emplace(std::move(work))) {
+        work();
+        return;
+      }
+    } else {
+      injection.push(std::move(work));
+    }
+
+    // Order the enqueue before the sleeper check with a read-modify-write, so
+    // that a worker about to park either is counted or sees the task
+    if (sleepers.fetch_add(0, std::memory_order_acq_rel) != 0) {
+      wake();
+    }
+  }
+
+  /// Returns the number of worker threads.
+  std::size_t size() const noexcept { return workers.size(); }
+
+ private:
+  /// State owned by one worker thread.
+  struct worker {
+    work_stealing_deque<task, deque_capacity> deque;
+    std::thread thread;
+  };
+
+  /// Identifies the pool and worker index of the calling thread.
+  struct worker_id {
+    thread_pool* pool;
+    std::size_t index;
+  };
+
+  /// Main loop of the worker at index.
+  void run(std::size_t index) noexcept {
+    current = {this, index};
+    std::uint64_t seed = index * 0x9e3779b97f4a7c15ULL + 1;
+
+    while (true) {
+      std::optional<task> work;
+      for (std::size_t round = 0; !work && round < spin_rounds; ++round) {
+        work = find_task(index, seed);
+        if (!work) {
+          cpu_relax();
+        }
+      }
+
+      if (work) {
+        (*work)();
+      } else if (!park()) {
+        break;
+      }
+    }
+  }
+
+  /// Looks for a task in the local deque, then the injection queue, then the
+  /// deques of other workers starting from a random victim.
+  std::optional<task> find_task(std::size_t index,
+                                std::uint64_t& seed) noexcept {
+    if (auto work = workers[index]->deque.try_pop()) {
+      return work;
+    }
+    if (auto work = injection.try_pop()) {
+      return work;
+    }
+
+    // Xorshift generator choosing the first victim
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    const auto count = workers.size();
+    const auto first = static_cast<std::size_t>(seed % count);
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto victim = (first + i) % count;
+      if (victim == index) {
+        continue;
+      }
+      if (auto work = workers[victim]->deque.try_steal()) {
+        return work;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// Parks the calling worker until work is submitted. Returns false if the
+  /// pool is stopping and no work is left.
+  bool park() noexcept {
+    const auto observed = epoch.load(std::memory_order_acquire);
+
+    // Announce the sleeper before the final check so that a concurrent submit
+    // either sees it or its task is seen here
+    sleepers.fetch_add(1, std::memory_order_acq_rel);
+    const bool idle = !has_work();
+    if (idle && stopping.load(std::memory_order_acquire)) {
+      sleepers.fetch_sub(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (idle) {
+      epoch.wait(observed, std::memory_order_acquire);
+    }
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// Returns true if any queue holds a task.
+  bool has_work() const noexcept {
+    if (!injection.empty()) {
+      return true;
+    }
+    for (const auto& w : workers) {
+      if (!w->deque.empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Wakes one parked worker.
+  void wake() noexcept {
+    epoch.fetch_add(1, std::memory_order_acq_rel);
+    epoch.notify_one();
+  }
+
+  static inline thread_local worker_id current = {nullptr, 0};
+
+  std::vector<std::unique_ptr<worker>> workers;
+  zeus::queue<task> injection;
+  alignas(hw_inf_size) std::atomic_uint32_t epoch = 0;
+  alignas(hw_inf_size) std::atomic_size_t sleepers = 0;
+  std::atomic_bool stopping = false;
+};
+}  // namespace zeus
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "zeus/slot.hpp"
+
+namespace zeus {
+/// Processor topology detected at run time, alongside the padding the queues
+/// were compiled with.
+struct cpu_topology {
+  /// Number of logical CPUs.
+  std::size_t cpus = 1;
+  /// Number of NUMA nodes, usually one per socket.
+  std::size_t numa_nodes = 1;
+  /// Coherency line size reported by the L1 data cache, or zero if unknown.
+  std::size_t cache_line_size = 0;
+  /// Alignment used to keep hot atomics on separate cache lines
+  /// (zeus::hw_inf_size).
+  std::size_t interference_size = hw_inf_size;
+};
+
+namespace detail {
+/// Parses a sysfs CPU or node list such as "0-3,8-11".
+inline std::vector<int> parse_id_list(const std::string& list) {
+  std::vector<int> ids;
+  std::size_t i = 0;
+  while (i < list.size()) {
+    std::size_t end = list.find(',', i);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    const std::string range = list.substr(i, end - i);
+    const std::size_t dash = range.find('-');
+    if (!range.empty() && range.front() >= '0' && range.front() <= '9') {
+      const int first = std::stoi(range.substr(0, dash));
+      const int last =
+          dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int id = first; id <= last; ++id) {
+        ids.push_back(id);
+      }
+    }
+    i = end + 1;
+  }
+  return ids;
+}
+
+/// Returns the first line of a sysfs file, or an empty string.
+inline std::string read_line(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+}  // namespace detail
+
+/// Returns the online NUMA nodes. Without NUMA support, node 0 is the only
+/// node.
+inline std::vector<int> numa_nodes() {
+#if defined(__linux__)
+  auto nodes = detail::parse_id_list(
+      detail::read_line("/sys/devices/system/node/online"));
+  if (!nodes.empty()) {
+    return nodes;
+  }
+#endif
+  return {0};
+}
+
+/// Returns the logical CPUs of the given NUMA node, or every CPU if the node
+/// is unknown.
+inline std::vector<int> numa_node_cpus(int node) {
+#if defined(__linux__)
+  auto cpus = detail::parse_id_list(detail::read_line(
+      "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+  if (!cpus.empty()) {
+    return cpus;
+  }
+  cpus = detail::parse_id_list(
+      detail::read_line("/sys/devices/system/cpu/online"));
+  if (!cpus.empty()) {
+    return cpus;
+  }
+#endif
+  std::vector<int> all(std::max(1u, std::thread::hardware_concurrency()));
+  for (std::size_t i = 0; i < all.size(); ++i) {
+    all[i] = static_cast<int>(i);
+  }
+  return all;
+}
+
+/// Returns the NUMA node of the CPU the calling thread runs on, or -1 if it
+/// cannot be determined.
+inline int current_numa_node() noexcept {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+  return -1;
+}
+
+/// Detects the processor topology from sysfs.
+inline cpu_topology detect_topology() {
+  cpu_topology topology;
+  topology.numa_nodes = numa_nodes().size();
+  topology.cpus = 0;
+  for (const int node : numa_nodes()) {
+    topology.cpus += numa_node_cpus(node).size();
+  }
+#if defined(__linux__)
+  const auto line_size = detail::read_line(
+      "/sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size");
+  if (!line_size.empty()) {
+    topology.cache_line_size = std::stoul(line_size);
+  }
+#endif
+  return topology;
+}
+}  // namespace zeus
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "zeus/latency.hpp"
+#include "zeus/layout.hpp"
+#include "zeus/stats.hpp"
+#include "zeus/wait.hpp"
+
+namespace zeus {
+/// Default compile-time configuration of zeus::queue. Customize a queue by
+/// deriving from this struct and shadowing the members to change.
+struct queue_traits {
+  /// Rounds the capacity up to the next power of two so that ticket-to-slot
+  /// mapping uses a mask and a shift instead of two hardware divides.
+  static constexpr bool power_of_two = false;
+
+  /// Memory layout of the slot array: padded_layout, compact_layout or
+  /// scrambled_layout.
+  using layout = padded_layout;
+
+  /// Strategy used by blocking operations to wait for a slot turn: spin_wait,
+  /// backoff_wait or park_wait.
+  using wait_strategy = spin_wait;
+
+  /// Allocator used for the slot array. Must honor alignof(U); see
+  /// zeus::huge_page_allocator for huge-page and NUMA-bound backing.
+  template <typename U>
+  using allocator = std::allocator<U>;
+
+  /// Skips constructing the slots when the allocator hands out zero-filled
+  /// memory, which it advertises with a static zero_filled member set to true
+  /// (zeus::huge_page_allocator does). Slots then start at turn zero from the
+  /// zero pages, so construction is O(1) and, without prefaulting, each page is
+  /// first touched by the thread that first uses it.
+  static constexpr bool lazy_init = false;
+
+  /// Number of tickets ahead of the current one whose slot is prefetched:
+  /// consumers prefetch for reading at tail + prefetch_distance, producers
+  /// for writing at head + prefetch_distance. Zero disables prefetching.
+  static constexpr std::size_t prefetch_distance = 0;
+
+  /// Number of tickets between two samples of head and tail published for
+  /// queue::approx_size(). Must be a power of two; zero disables sampling and
+  /// makes approx_size() read head and tail. Sampling adds a store to a
+  /// shared line on the push and pop paths, so it is opt-in.
+  static constexpr std::size_t size_sample_interval = 0;
+
+  /// Statistics collected by the queue: no_stats, which compiles the
+  /// instrumentation out, or sharded_stats, read through queue::snapshot().
+  using stats = no_stats;
+
+  /// Latency tracing: no_tracing, which compiles it out, or
+  /// residency_histogram, which stamps each slot on enqueue and records the
+  /// time items spend in the queue, read through queue::residency().
+  using tracing = no_tracing;
+};
+}  // namespace zeus
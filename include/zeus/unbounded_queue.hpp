@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "zeus/slot.hpp"
+#include "zeus/traits.hpp"
+#include "zeus/wait.hpp"
+
+namespace zeus {
+/// Unbounded lock-free queue supporting multiple producers and consumers,
+/// built from a linked list of fixed-size segments of SegmentSize slots.
+/// Producers and consumers claim slots in the current segment with tickets,
+/// as in zeus::queue, except that each slot is used once per segment
+/// lifetime. The producer that claims the first ticket past the end of a
+/// segment links a new one; other producers wait for it.
+///
+/// Retired segments are recycled through a free list instead of being
+/// returned to the allocator, so once the queue has grown to its working
+/// size it allocates nothing. Segments are only freed when the queue is
+/// destroyed, which lets threads holding a stale segment pointer safely
+/// touch its reference count.
+template <regular_type T,
+          std::size_t SegmentSize = 256,
+          typename Traits = queue_traits>
+class unbounded_queue {
+  static_assert(SegmentSize >= 1, "segments must hold at least one slot");
+
+  using slot_type = zeus::slot<T, Traits::layout::alignment>;
+
+  /// Turns of a slot over one segment lifetime.
+  static constexpr std::size_t empty_turn = 0;
+  static constexpr std::size_t full_turn = 1;
+  static constexpr std::size_t taken_turn = 2;
+
+  /// Fixed-size ring segment. refs counts the threads using the segment,
+  /// plus retired once consumers have moved past it. linked turns to 1 once
+  /// next is set, giving the wait strategy a word to wait on.
+  struct segment {
+    alignas(hw_inf_size) std::atomic_size_t head = 0;
+    alignas(hw_inf_size) std::atomic_size_t tail = 0;
+    alignas(hw_inf_size) std::atomic<segment*> next = nullptr;
+    std::atomic_size_t linked = 0;
+    std::atomic_size_t refs = 0;
+    std::atomic<segment*> free_next = nullptr;
+    slot_type slots[SegmentSize];
+  };
+
+  /// Flag added to the reference count of a retired segment.
+  static constexpr std::size_t retired = std::size_t{1}
+                                         << (sizeof(std::size_t) * 8 - 1);
+
+ public:
+  /// Constructs an empty queue holding a single segment.
+  unbounded_queue() : allocated(1) {
+    segment* first = new segment();
+    head_segment.store(first, std::memory_order_relaxed);
+    tail_segment.store(first, std::memory_order_relaxed);
+  }
+
+  /// Destroys the queue along with every remaining item and segment.
+  ~unbounded_queue() noexcept {
+    segment* current = head_segment.load(std::memory_order_relaxed);
+    while (current != nullptr) {
+      delete std::exchange(current,
+                           current->next.load(std::memory_order_relaxed));
+    }
+    current = free_list.load(std::memory_order_relaxed);
+    while (current != nullptr) {
+      delete std::exchange(
+          current, current->free_next.load(std::memory_order_relaxed));
+    }
+  }
+
+  unbounded_queue(const unbounded_queue&) = delete;
+  unbounded_queue& operator=(const unbounded_queue&) = delete;
+
+  /// Enqueues an item by in-place construction. Never blocks on consumers,
+  /// but waits for the producer that links a new segment when the current
+  /// one fills up. Calls std::terminate if a segment cannot be allocated.
+  template <typename... A>
+    requires std::is_nothrow_constructible<T, A&&...>::value
+  void emplace(A&&... arguments) noexcept {
+    while (true) {
+      segment* current = acquire(tail_segment);
+      const auto ticket = current->head.fetch_add(1);
+
+      if (ticket < SegmentSize) {
+        slot_type& slot = current->slots[ticket];
+        slot.construct(std::forward<A>(arguments)...);
+        slot.turn.store(full_turn, std::memory_order_release);
+        waiter.notify(slot.turn);
+        release(current);
+        return;
+      }
+
+      if (ticket == SegmentSize) {
+        // Publish the new segment to producers before consumers can retire
+        // this one through its next pointer
+        segment* fresh = allocate();
+        tail_segment.store(fresh, std::memory_order_release);
+        current->next.store(fresh, std::memory_order_release);
+        current->linked.store(1, std::memory_order_release);
+        waiter.notify(current->linked);
+      } else {
+        // Block while waiting for the producer that claimed the end of the
+        // segment to link a new one
+        wait_linked(current);
+      }
+      release(current);
+    }
+  }
+
+  /// Enqueues an item using move or copy construction.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  void push(P&& value) noexcept {
+    emplace(std::forward<P>(value));
+  }
+
+  /// Removes and returns the front item from the queue, blocking if the queue
+  /// is empty.
+  T pop() noexcept
+    requires std::is_nothrow_move_constructible<T>::value
+  {
+    while (true) {
+      segment* current = acquire(head_segment);
+      const auto ticket = current->tail.fetch_add(1);
+
+      if (ticket < SegmentSize) {
+        slot_type& slot = current->slots[ticket];
+
+        // Block while waiting for the producer of the ticket
+        waiter.wait(slot.turn,
+                    [](auto turn) { return turn == full_turn; });
+
+        T rv(take(slot));
+        release(current);
+        return rv;
+      }
+
+      // Block while waiting for the next segment, then move past this one
+      wait_linked(current);
+      advance(current);
+      release(current);
+    }
+  }
+
+  /// Attempts to remove and return the front item from the queue. Returns the
+  /// item if successful, or an empty optional if the queue is empty.
+  std::optional<T> try_pop() noexcept {
+    while (true) {
+      segment* current = acquire(head_segment);
+      auto ticket = current->tail.load(std::memory_order_acquire);
+
+      while (ticket < SegmentSize) {
+        slot_type& slot = current->slots[ticket];
+        if (slot.turn.load(std::memory_order_acquire) == full_turn) {
+          // If the slot holds an item, try to claim it
+          if (current->tail.compare_exchange_strong(ticket, ticket + 1)) {
+            std::optional<T> rv(take(slot));
+            release(current);
+            return rv;
+          }
+        } else {
+          // If tail hasn't changed, queue is empty
+          const auto prev_ticket = ticket;
+          ticket = current->tail.load(std::memory_order_acquire);
+          if (ticket == prev_ticket) {
+            release(current);
+            return std::nullopt;
+          }
+        }
+      }
+
+      // The segment is exhausted, so move to the next one if it is linked
+      if (current->next.load(std::memory_order_acquire) == nullptr) {
+        release(current);
+        return std::nullopt;
+      }
+      advance(current);
+      release(current);
+    }
+  }
+
+  /// Returns true if the queue is empty, otherwise false. The result is not
+  /// guaranteed to be accurate.
+  bool empty() const noexcept {
+    const segment* current = head_segment.load(std::memory_order_acquire);
+    const auto tail = current->tail.load(std::memory_order_relaxed);
+    const auto head = current->head.load(std::memory_order_relaxed);
+    return tail >= std::min(head, SegmentSize) &&
+           current->next.load(std::memory_order_relaxed) == nullptr;
+  }
+
+  /// Returns the number of segments allocated so far, including those on the
+  /// free list.
+  std::size_t segments() const noexcept {
+    return allocated.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /// Takes a reference on the segment stored in which and returns it. The
+  /// reference is taken before validating that the segment is still current,
+  /// so the segment cannot be recycled while it is in use.
+  segment* acquire(const std::atomic<segment*>& which) noexcept {
+    segment* current = which.load(std::memory_order_acquire);
+    while (true) {
+      current->refs.fetch_add(1, std::memory_order_acq_rel);
+      segment* loaded = which.load(std::memory_order_acquire);
+      if (loaded == current) {
+        return current;
+      }
+      release(current);
+      current = loaded;
+    }
+  }
+
+  /// Drops a reference on a segment, recycling it if it was the last
+  /// reference to a retired segment. A thread with a stale pointer may take
+  /// and drop a transient reference at any time, so the thread that clears
+  /// the retired flag from a count of exactly retired is the one that owns
+  /// the recycling.
+  void release(segment* current) noexcept {
+    if (current->refs.fetch_sub(1, std::memory_order_acq_rel) ==
+        retired + 1) {
+      auto expected = retired;
+      if (current->refs.compare_exchange_strong(
+              expected, 0, std::memory_order_acq_rel,
+              std::memory_order_relaxed)) {
+        recycle(current);
+      }
+    }
+  }
+
+  /// Moves the consumers from the exhausted segment current to its successor,
+  /// retiring current if this thread moved them.
+  void advance(segment* current) noexcept {
+    segment* expected = current;
+    if (head_segment.compare_exchange_strong(
+            expected, current->next.load(std::memory_order_acquire))) {
+      current->refs.fetch_add(retired, std::memory_order_acq_rel);
+    }
+  }
+
+  /// Blocks until a successor is linked to the segment current, on which the
+  /// caller holds a reference.
+  void wait_linked(segment* current) noexcept {
+    waiter.wait(current->linked, [](auto linked) { return linked != 0; });
+  }
+
+  /// Moves the item out of a claimed slot and marks it taken.
+  T take(slot_type& slot) noexcept {
+    T rv(slot.move());
+    slot.destroy();
+    slot.turn.store(taken_turn, std::memory_order_relaxed);
+    return rv;
+  }
+
+  /// Resets a retired segment owned by the calling thread and pushes it onto
+  /// the free list. Threads with stale pointers may still take transient
+  /// references, which are kept in the count, but never touch anything else.
+  void recycle(segment* current) noexcept {
+    current->head.store(0, std::memory_order_relaxed);
+    current->tail.store(0, std::memory_order_relaxed);
+    current->next.store(nullptr, std::memory_order_relaxed);
+    current->linked.store(0, std::memory_order_relaxed);
+    for (auto& slot : current->slots) {
+      slot.turn.store(empty_turn, std::memory_order_relaxed);
+    }
+
+    segment* top = free_list.load(std::memory_order_relaxed);
+    do {
+      current->free_next.store(top, std::memory_order_relaxed);
+    } while (!free_list.compare_exchange_weak(top, current,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+  }
+
+  /// Returns a segment from the free list, or a newly allocated one. Only the
+  /// producer closing the tail segment calls this, so pops from the free list
+  /// never race each other and cannot suffer from ABA.
+  segment* allocate() noexcept {
+    segment* top = free_list.load(std::memory_order_acquire);
+    while (top != nullptr) {
+      if (free_list.compare_exchange_weak(
+              top, top->free_next.load(std::memory_order_relaxed),
+              std::memory_order_acquire, std::memory_order_acquire)) {
+        return top;
+      }
+    }
+    allocated.fetch_add(1, std::memory_order_relaxed);
+    return new segment();
+  }
+
+  [[no_unique_address]] typename Traits::wait_strategy waiter;
+  std::atomic_size_t allocated;
+
+  alignas(hw_inf_size) std::atomic<segment*> head_segment = nullptr;
+  alignas(hw_inf_size) std::atomic<segment*> tail_segment = nullptr;
+  alignas(hw_inf_size) std::atomic<segment*> free_list = nullptr;
+};
+}  // namespace zeus
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+
+#include "zeus/slot.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace zeus {
+/// Hints to the processor that the calling thread is busy-waiting.
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield");
+#endif
+}
+
+/// Number of turn checks between two clock reads in timed waits.
+inline constexpr std::size_t deadline_check_interval = 64;
+
+/// Wait strategy that spins on the slot turn with a pause instruction. Lowest
+/// wake-up latency, but burns a full core while waiting.
+struct spin_wait {
+  /// Blocks until ready returns true for the current value of word.
+  template <typename P>
+  void wait(const std::atomic_size_t& word, P&& ready) noexcept {
+    while (!ready(word.load(std::memory_order_acquire))) {
+      cpu_relax();
+    }
+  }
+
+  /// Blocks until ready returns true for the current value of word or the
+  /// deadline passes. Returns false on timeout.
+  template <typename P, typename Clock, typename Duration>
+  bool wait_until(
+      const std::atomic_size_t& word,
+      P&& ready,
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+    while (true) {
+      for (std::size_t i = 0; i < deadline_check_interval; ++i) {
+        if (ready(word.load(std::memory_order_acquire))) {
+          return true;
+        }
+        cpu_relax();
+      }
+      if (Clock::now() >= deadline) {
+        return ready(word.load(std::memory_order_acquire));
+      }
+    }
+  }
+
+  /// Wakes threads waiting on word after it has been updated.
+  void notify(std::atomic_size_t&) noexcept {}
+};
+
+/// Wait strategy that spins with exponentially growing pauses, then yields the
+/// processor once the pause budget is exhausted.
+template <std::size_t MaxPauses = 1024>
+struct backoff_wait {
+  /// Blocks until ready returns true for the current value of word.
+  template <typename P>
+  void wait(const std::atomic_size_t& word, P&& ready) noexcept {
+    std::size_t pauses = 1;
+    while (!ready(word.load(std::memory_order_acquire))) {
+      if (pauses <= MaxPauses) {
+        for (std::size_t i = 0; i < pauses; ++i) {
+          cpu_relax();
+        }
+        pauses *= 2;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /// Blocks until ready returns true for the current value of word or the
+  /// deadline passes. Returns false on timeout.
+  template <typename P, typename Clock, typename Duration>
+  bool wait_until(
+      const std::atomic_size_t& word,
+      P&& ready,
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+    std::size_t pauses = 1;
+    while (!ready(word.load(std::memory_order_acquire))) {
+      if (Clock::now() >= deadline) {
+        return false;
+      }
+      if (pauses <= MaxPauses) {
+        for (std::size_t i = 0; i < pauses; ++i) {
+          cpu_relax();
+        }
+        pauses *= 2;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    return true;
+  }
+
+  /// Wakes threads waiting on word after it has been updated.
+  void notify(std::atomic_size_t&) noexcept {}
+};
+
+/// Wait strategy that spins for SpinLimit iterations, then parks the thread on
+/// the slot turn using std::atomic::wait. Notifiers only issue a wake-up when
+/// at least one thread is parked. Timed waits sleep for at most max_sleep
+/// between turn checks once the spin budget is exhausted.
+template <std::size_t SpinLimit = 1024>
+class park_wait {
+ public:
+  /// Longest sleep between two turn checks in timed waits.
+  static constexpr std::chrono::microseconds max_sleep{1000};
+
+  /// Blocks until ready returns true for the current value of word.
+  template <typename P>
+  void wait(const std::atomic_size_t& word, P&& ready) noexcept {
+    for (std::size_t i = 0; i < SpinLimit; ++i) {
+      if (ready(word.load(std::memory_order_acquire))) {
+        return;
+      }
+      cpu_relax();
+    }
+
+    // Announce the waiter before the final check so that a concurrent notify
+    // either sees it or its turn update is seen here
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    while (true) {
+      const auto current = word.load(std::memory_order_seq_cst);
+      if (ready(current)) {
+        break;
+      }
+      word.wait(current, std::memory_order_acquire);
+    }
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Blocks until ready returns true for the current value of word or the
+  /// deadline passes. Returns false on timeout. std::atomic::wait has no
+  /// timeout, so after spinning the thread sleeps in exponentially growing
+  /// steps of at most max_sleep instead of parking on the turn.
+  template <typename P, typename Clock, typename Duration>
+  bool wait_until(
+      const std::atomic_size_t& word,
+      P&& ready,
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+    for (std::size_t i = 0; i < SpinLimit; ++i) {
+      if (ready(word.load(std::memory_order_acquire))) {
+        return true;
+      }
+      if (i % deadline_check_interval == 0 && Clock::now() >= deadline) {
+        return false;
+      }
+      cpu_relax();
+    }
+
+    std::chrono::microseconds sleep(1);
+    while (!ready(word.load(std::memory_order_acquire))) {
+      const auto now = Clock::now();
+      if (now >= deadline) {
+        return false;
+      }
+      std::this_thread::sleep_until(std::min<decltype(now + sleep)>(
+          deadline, now + sleep));
+      sleep = std::min(sleep * 2, max_sleep);
+    }
+    return true;
+  }
+
+  /// Wakes threads waiting on word after it has been updated.
+  void notify(std::atomic_size_t& word) noexcept {
+    // Re-publish the updated turn with a sequentially consistent
+    // read-modify-write so that it is ordered against waiter registration
+    word.fetch_add(0, std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_seq_cst) != 0) {
+      word.notify_all();
+    }
+  }
+
+ private:
+  alignas(hw_inf_size) std::atomic_size_t waiters = 0;
+};
+
+/// Epoch that consumers of several rings wait on through WaitStrategy until
+/// an item is published to any of them. Consumers call prepare_wait(), check
+/// their rings again, then wait() or cancel_wait(). Producers call notify()
+/// after publishing, which costs a fence and a read of the waiter count while
+/// nobody waits. With spin_wait there is nothing to wake: consumers poll
+/// their rings and notify() compiles to nothing.
+template <typename WaitStrategy>
+class wait_epoch {
+  static constexpr bool polling = std::is_same_v<WaitStrategy, spin_wait>;
+
+ public:
+  /// Registers the calling thread as a waiter and returns the key to pass to
+  /// wait(). The caller must check its rings again before waiting.
+  std::size_t prepare_wait() noexcept {
+    if constexpr (polling) {
+      return 0;
+    } else {
+      waiters.fetch_add(1, std::memory_order_seq_cst);
+#if !defined(__SANITIZE_THREAD__)
+      // Pairs with the fence in notify(): either the producer sees the waiter
+      // or the caller's next check of its rings sees the item
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+      return epoch.load(std::memory_order_seq_cst);
+    }
+  }
+
+  /// Unregisters a waiter whose rings held an item after prepare_wait().
+  void cancel_wait() noexcept {
+    if constexpr (!polling) {
+      waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  /// Blocks until notify() is called after prepare_wait() returned key, then
+  /// unregisters the waiter. Returns at once when polling.
+  void wait(std::size_t key) noexcept {
+    if constexpr (polling) {
+      cpu_relax();
+    } else {
+      strategy.wait(epoch, [key](auto current) { return current != key; });
+      waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  /// Blocks until notify() is called after prepare_wait() returned key or the
+  /// deadline passes, then unregisters the waiter. Returns false on timeout.
+  /// Returns at once when polling, with false once the deadline has passed.
+  template <typename Clock, typename Duration>
+  bool wait_until(
+      std::size_t key,
+      const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+    if constexpr (polling) {
+      cpu_relax();
+      return Clock::now() < deadline;
+    } else {
+      const bool notified = strategy.wait_until(
+          epoch, [key](auto current) { return current != key; }, deadline);
+      waiters.fetch_sub(1, std::memory_order_relaxed);
+      return notified;
+    }
+  }
+
+  /// Wakes every waiter. Called after an item is published.
+  void notify() noexcept {
+    if constexpr (!polling) {
+#if defined(__SANITIZE_THREAD__)
+      // ThreadSanitizer does not model fences, so order through waiters
+      if (waiters.fetch_add(0, std::memory_order_acq_rel) == 0) {
+        return;
+      }
+#else
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (waiters.load(std::memory_order_relaxed) == 0) {
+        return;
+      }
+#endif
+      epoch.fetch_add(1, std::memory_order_release);
+      strategy.notify(epoch);
+    }
+  }
+
+ private:
+  [[no_unique_address]] WaitStrategy strategy;
+  alignas(hw_inf_size) std::atomic_size_t waiters = 0;
+  alignas(hw_inf_size) std::atomic_size_t epoch = 0;
+};
+}  // namespace zeus
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "zeus/slot.hpp"
+
+namespace zeus {
+/// Bounded Chase-Lev work-stealing deque. The owning thread pushes and pops
+/// items at the bottom in LIFO order, while any other thread steals items from
+/// the top in FIFO order. Thieves move an item out only after claiming it, and
+/// the turn of each slot stays odd until its item has been moved out, so the
+/// owner never overwrites an item that a slow thief is still reading.
+template <typename T, std::size_t Capacity = 256>
+  requires std::is_nothrow_move_constructible<T>::value &&
+           std::is_nothrow_destructible<T>::value
+class work_stealing_deque {
+  static_assert(std::has_single_bit(Capacity),
+                "work_stealing_deque requires a power-of-two capacity");
+
+ public:
+  work_stealing_deque() noexcept = default;
+
+  work_stealing_deque(const work_stealing_deque&) = delete;
+  work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+  /// Pushes an item at the bottom. Returns false if the deque is full. Must
+  /// only be called by the owning thread.
+  template <typename P>
+    requires std::is_nothrow_constructible<T, P&&>::value
+  bool try_push(P&& value) noexcept {
+    const auto current_bottom = bottom.load(std::memory_order_relaxed);
+    slot_type& slot = slots[current_bottom & mask];
+
+    // The slot still holds the item pushed Capacity positions ago
+    if (slot.turn.load(std::memory_order_acquire) != 0) {
+      return false;
+    }
+
+    slot.construct(std::forward<P>(value));
+    slot.turn.store(1, std::memory_order_relaxed);
+    bottom.store(current_bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Removes and returns the bottom item, or an empty optional if the deque
+  /// is empty. Must only be called by the owning thread.
+  std::optional<T> try_pop() noexcept {
+    auto current_bottom = bottom.load(std::memory_order_relaxed);
+    if (top.load(std::memory_order_relaxed) >= current_bottom) {
+      return std::nullopt;
+    }
+
+    // Reserve the bottom item before checking for thieves. Both operations
+    // are sequentially consistent so that a concurrent steal either sees the
+    // reservation or its claim is seen here.
+    --current_bottom;
+    bottom.store(current_bottom, std::memory_order_seq_cst);
+    auto current_top = top.load(std::memory_order_seq_cst);
+
+    if (current_top < current_bottom) {
+      return take(current_bottom);
+    }
+
+    // The last item is contended by thieves, so claim it through the top
+    bool claimed = current_top == current_bottom &&
+                   top.compare_exchange_strong(current_top, current_top + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed);
+    bottom.store(current_bottom + 1, std::memory_order_release);
+    if (!claimed) {
+      return std::nullopt;
+    }
+    return take(current_bottom);
+  }
+
+  /// Removes and returns the top item, or an empty optional if the deque is
+  /// empty or another thread claimed the item first. Safe to call from any
+  /// thread.
+  std::optional<T> try_steal() noexcept {
+    auto current_top = top.load(std::memory_order_seq_cst);
+    const auto current_bottom = bottom.load(std::memory_order_seq_cst);
+    if (current_top >= current_bottom) {
+      return std::nullopt;
+    }
+
+    if (!top.compare_exchange_strong(current_top, current_top + 1,
+                                     std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+    return take(current_top);
+  }
+
+  /// Returns the number of items in the deque. The size is not guaranteed to
+  /// be accurate.
+  std::ptrdiff_t size() const noexcept {
+    return static_cast<std::ptrdiff_t>(bottom.load(std::memory_order_relaxed) -
+                                       top.load(std::memory_order_relaxed));
+  }
+
+  /// Returns true if the deque is empty, otherwise false.
+  bool empty() const noexcept { return size() <= 0; }
+
+  /// Returns the number of items the deque can hold.
+  static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+ private:
+  static constexpr std::size_t mask = Capacity - 1;
+
+  /// Slots are packed, with a turn of 1 while an item is stored.
+  using slot_type = slot<T, alignof(std::atomic_size_t)>;
+
+  /// Moves the claimed item at position out of its slot and frees the slot.
+  std::optional<T> take(std::size_t position) noexcept {
+    slot_type& slot = slots[position & mask];
+    std::optional<T> rv(slot.move());
+    slot.destroy();
+    slot.turn.store(0, std::memory_order_release);
+    return rv;
+  }
+
+  // Thieves claim from the top, the owner pushes and pops at the bottom
+  alignas(hw_inf_size) std::atomic_size_t top = 0;
+  alignas(hw_inf_size) std::atomic_size_t bottom = 0;
+  alignas(hw_inf_size) slot_type slots[Capacity];
+};
+}  // namespace zeus
@@ -0,0 +1,619 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "zeus/queue.hpp"
+#include "zeus/sharded_queue.hpp"
+#include "zeus/spsc_queue.hpp"
+#include "zeus/unbounded_queue.hpp"
+
+// Randomized stress test for zeus queues. Each scenario runs a random number
+// of producers and consumers for a fixed duration. Every thread picks a
+// random operation for each step, mixing blocking, timed, try_*, bulk,
+// in-place and reservation calls. Consumers check that the items of each
+// producer arrive in order and the run checks that every item is delivered
+// exactly once. Small and non-power-of-two capacities make the turn counters
+// wrap around the ring constantly.
+//
+// Environment variables:
+//   ZEUS_STRESS_SECONDS  duration of each scenario (default 2)
+//   ZEUS_STRESS_THREADS  upper bound of producers and of consumers
+//                        (default 4)
+//   ZEUS_STRESS_ITEMS    upper bound of items per producer (default 1 << 20)
+//   ZEUS_STRESS_SEED     seed of the scenario configurations and of the
+//                        operation mixes (default: random, printed)
+//
+// Exits with a non-zero status if any check fails. Where perf_event_open is
+// permitted, cache and branch misses per item are reported with ops/sec.
+
+namespace {
+/// Item tagged with its producer and its position in the producer's stream.
+/// Pills tell consumers to stop.
+struct item {
+  static constexpr std::uint64_t pill = UINT64_MAX;
+
+  item() noexcept = default;
+  item(std::uint32_t producer, std::uint64_t seq) noexcept
+      : producer(producer), seq(seq) {}
+
+  std::uint32_t producer = 0;
+  std::uint64_t seq = pill;
+};
+
+/// Returns the value of an environment variable, or fallback if it is unset.
+double env_or(const char* name, double fallback) {
+  const char* value = std::getenv(name);
+  return value ? std::stod(value) : fallback;
+}
+
+/// Run-wide settings parsed from the environment.
+struct settings {
+  double seconds = env_or("ZEUS_STRESS_SECONDS", 2);
+  std::size_t threads =
+      static_cast<std::size_t>(env_or("ZEUS_STRESS_THREADS", 4));
+  std::uint64_t items =
+      static_cast<std::uint64_t>(env_or("ZEUS_STRESS_ITEMS", 1 << 20));
+  std::uint64_t seed = static_cast<std::uint64_t>(
+      env_or("ZEUS_STRESS_SEED", static_cast<double>(std::random_device()())));
+};
+
+/// Hardware counters of the whole process, children threads included.
+class perf_counters {
+ public:
+  static constexpr std::size_t count = 3;
+
+  perf_counters() {
+#if defined(__linux__)
+    const std::uint64_t configs[count] = {PERF_COUNT_HW_INSTRUCTIONS,
+                                          PERF_COUNT_HW_CACHE_MISSES,
+                                          PERF_COUNT_HW_BRANCH_MISSES};
+    for (std::size_t i = 0; i < count; ++i) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.disabled = 1;
+      attr.inherit = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds[i] = static_cast<int>(
+          syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+  }
+
+  ~perf_counters() {
+#if defined(__linux__)
+    for (const int fd : fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  perf_counters(const perf_counters&) = delete;
+  perf_counters& operator=(const perf_counters&) = delete;
+
+  /// Resets and starts the counters. Threads spawned afterwards are counted.
+  void start() {
+#if defined(__linux__)
+    for (const int fd : fds) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  /// Stops the counters and returns their values, or empty optionals for the
+  /// counters that could not be opened. Joined threads are included.
+  std::array<std::optional<std::uint64_t>, count> stop() {
+    std::array<std::optional<std::uint64_t>, count> values;
+#if defined(__linux__)
+    for (std::size_t i = 0; i < count; ++i) {
+      std::uint64_t value = 0;
+      if (fds[i] >= 0) {
+        ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fds[i], &value, sizeof(value)) == sizeof(value)) {
+          values[i] = value;
+        }
+      }
+    }
+#endif
+    return values;
+  }
+
+ private:
+  int fds[count] = {-1, -1, -1};
+};
+
+/// Checks the items received by one consumer.
+class checker {
+ public:
+  checker(std::vector<std::unique_ptr<std::atomic_uint8_t[]>>& seen,
+          std::uint64_t items)
+      : seen(seen), items(items), expected(seen.size(), 0) {}
+
+  /// Records an item, returning false if it is a pill.
+  bool operator()(const item& value) noexcept {
+    if (value.seq == item::pill) {
+      pills = true;
+      return false;
+    }
+    if (value.producer >= expected.size() || value.seq >= items) {
+      ++corrupt;
+    } else {
+      // A consumer claims tickets in increasing order, so it must see the
+      // items of a producer in the order they were pushed
+      if (value.seq < expected[value.producer]) {
+        ++reordered;
+      }
+      expected[value.producer] = value.seq + 1;
+      seen[value.producer][value.seq].fetch_add(1,
+                                                std::memory_order_relaxed);
+    }
+    ++received;
+    return true;
+  }
+
+  bool stopped() const noexcept { return pills; }
+
+  std::vector<std::unique_ptr<std::atomic_uint8_t[]>>& seen;
+  std::uint64_t items;
+  std::vector<std::uint64_t> expected;
+  std::uint64_t received = 0;
+  std::uint64_t reordered = 0;
+  std::uint64_t corrupt = 0;
+  bool pills = false;
+};
+
+/// Returns a random number of items for a bulk operation, at most the items
+/// the producer has left.
+std::size_t batch_size(std::mt19937_64& rng, std::uint64_t seq,
+                       std::uint64_t last) {
+  return static_cast<std::size_t>(
+      std::min<std::uint64_t>(1 + rng() % 8, last - seq));
+}
+
+/// Exercises every operation of zeus::queue.
+template <typename Traits>
+struct queue_adapter {
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = true;
+  static constexpr bool fifo = true;
+
+  explicit queue_adapter(std::size_t capacity) : queue(capacity) {}
+
+  std::size_t capacity() const { return queue.capacity(); }
+
+  void produce(std::mt19937_64& rng, std::uint32_t producer,
+               std::uint64_t& seq, std::uint64_t last) {
+    std::array<item, 8> batch;
+    const auto n = batch_size(rng, seq, last);
+    for (std::size_t i = 0; i < n; ++i) {
+      batch[i] = item(producer, seq + i);
+    }
+
+    switch (rng() % 8) {
+      case 0:
+        queue.push(batch[0]);
+        break;
+      case 1:
+        queue.emplace(producer, seq);
+        break;
+      case 2:
+        while (!queue.try_push(batch[0])) {
+          std::this_thread::yield();
+        }
+        break;
+      case 3:
+        while (!queue.try_push_for(batch[0], std::chrono::microseconds(50))) {
+        }
+        break;
+      case 4:
+        queue.push_bulk(batch.begin(), batch.begin() + n);
+        seq += n;
+        return;
+      case 5:
+        for (std::size_t done = 0; done < n;) {
+          done += queue.try_push_bulk(batch.begin() + done, batch.begin() + n);
+          if (done < n) {
+            std::this_thread::yield();
+          }
+        }
+        seq += n;
+        return;
+      case 6: {
+        auto reservation = queue.begin_push();
+        *reservation = batch[0];
+        break;
+      }
+      default: {
+        // The reservation commits as soon as the temporary is destroyed
+        while (!queue.try_begin_push(producer, seq)) {
+          std::this_thread::yield();
+        }
+        break;
+      }
+    }
+    ++seq;
+  }
+
+  bool try_push_pill() { return queue.try_push(item()); }
+
+  void consume(std::mt19937_64& rng, checker& check) {
+    std::array<item, 8> batch;
+    const auto n = 1 + rng() % 8;
+
+    switch (rng() % 11) {
+      case 0:
+        check(queue.pop());
+        break;
+      case 1: {
+        item value;
+        queue.pop(value);
+        check(value);
+        break;
+      }
+      case 2:
+        check(*queue.wait_pop());
+        break;
+      case 3:
+        if (auto value = queue.try_pop()) {
+          check(*value);
+        }
+        break;
+      case 4:
+        if (auto value = queue.try_pop_for(std::chrono::microseconds(50))) {
+          check(*value);
+        }
+        break;
+      case 5:
+        queue.pop_bulk(batch.begin(), n);
+        std::for_each(batch.begin(), batch.begin() + n, std::ref(check));
+        break;
+      case 6: {
+        const auto count = queue.try_pop_bulk(batch.begin(), n);
+        std::for_each(batch.begin(), batch.begin() + count, std::ref(check));
+        break;
+      }
+      case 7:
+        queue.consume_one([&check](item& value) noexcept { check(value); });
+        break;
+      case 8:
+        queue.consume_all([&check](item& value) noexcept { check(value); },
+                          n);
+        break;
+      case 9:
+        check(*queue.begin_pop());
+        break;
+      default:
+        if (auto reservation = queue.try_begin_pop()) {
+          check(**reservation);
+        }
+        break;
+    }
+  }
+
+  zeus::queue<item, zeus::dynamic_capacity, Traits> queue;
+};
+
+/// Exercises zeus::sharded_queue, whose lanes hold capacity items each.
+struct sharded_adapter {
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = true;
+  static constexpr bool fifo = false;
+
+  explicit sharded_adapter(std::size_t capacity) : queue(4, capacity) {}
+
+  std::size_t capacity() const { return queue.capacity(); }
+
+  void produce(std::mt19937_64& rng, std::uint32_t producer,
+               std::uint64_t& seq, std::uint64_t) {
+    const item value(producer, seq++);
+    if (rng() % 2 == 0) {
+      queue.push(value);
+    } else {
+      while (!queue.try_push(value)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  bool try_push_pill() { return queue.try_push(item()); }
+
+  void consume(std::mt19937_64& rng, checker& check) {
+    if (rng() % 2 == 0) {
+      check(queue.pop());
+    } else if (auto value = queue.try_pop()) {
+      check(*value);
+    }
+  }
+
+  zeus::sharded_queue<item> queue;
+};
+
+/// Exercises zeus::spsc_queue with one producer and one consumer.
+struct spsc_adapter {
+  static constexpr bool multi_producer = false;
+  static constexpr bool multi_consumer = false;
+  static constexpr bool fifo = true;
+
+  explicit spsc_adapter(std::size_t capacity)
+      : queue(capacity), max_capacity(capacity) {}
+
+  std::size_t capacity() const { return max_capacity; }
+
+  void produce(std::mt19937_64& rng, std::uint32_t producer,
+               std::uint64_t& seq, std::uint64_t) {
+    const item value(producer, seq++);
+    switch (rng() % 3) {
+      case 0:
+        queue.push(value);
+        break;
+      case 1:
+        queue.emplace(value);
+        break;
+      default:
+        while (!queue.try_push(value)) {
+          std::this_thread::yield();
+        }
+        break;
+    }
+  }
+
+  bool try_push_pill() { return queue.try_push(item()); }
+
+  void consume(std::mt19937_64& rng, checker& check) {
+    switch (rng() % 3) {
+      case 0:
+        check(queue.pop());
+        break;
+      case 1: {
+        item value;
+        queue.pop(value);
+        check(value);
+        break;
+      }
+      default:
+        if (auto value = queue.try_pop()) {
+          check(*value);
+        }
+        break;
+    }
+  }
+
+  zeus::spsc_queue<item> queue;
+  std::size_t max_capacity;
+};
+
+/// Exercises zeus::unbounded_queue with small segments.
+struct unbounded_adapter {
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = true;
+  static constexpr bool fifo = true;
+
+  explicit unbounded_adapter(std::size_t) {}
+
+  std::size_t capacity() const { return 0; }
+
+  void produce(std::mt19937_64&, std::uint32_t producer, std::uint64_t& seq,
+               std::uint64_t) {
+    queue.push(item(producer, seq++));
+  }
+
+  bool try_push_pill() {
+    queue.push(item());
+    return true;
+  }
+
+  void consume(std::mt19937_64& rng, checker& check) {
+    if (rng() % 2 == 0) {
+      check(queue.pop());
+    } else if (auto value = queue.try_pop()) {
+      check(*value);
+    }
+  }
+
+  zeus::unbounded_queue<item, 8> queue;
+};
+
+/// Runs one scenario and prints its results. Returns false if a check
+/// failed.
+template <typename Adapter>
+bool run(const char* name, const settings& config, std::mt19937_64& rng) {
+  const auto pick_threads = [&] {
+    return 1 + static_cast<std::size_t>(rng() % config.threads);
+  };
+  const std::size_t producers = Adapter::multi_producer ? pick_threads() : 1;
+  const std::size_t consumers = Adapter::multi_consumer ? pick_threads() : 1;
+  constexpr std::size_t capacities[] = {1, 2, 3, 7, 8, 64, 1000};
+  Adapter queue(capacities[rng() % std::size(capacities)]);
+
+  std::vector<std::unique_ptr<std::atomic_uint8_t[]>> seen;
+  for (std::size_t p = 0; p < producers; ++p) {
+    seen.push_back(std::make_unique<std::atomic_uint8_t[]>(config.items));
+  }
+  std::vector<std::uint64_t> produced(producers, 0);
+  std::vector<checker> checks(consumers, checker(seen, config.items));
+
+  std::atomic_bool stop = false;
+  std::atomic_size_t producers_left = producers;
+  std::atomic_size_t consumers_left = consumers;
+  std::atomic_uint64_t delivered = 0;
+
+  perf_counters counters;
+  counters.start();
+  const auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p, seed = rng()] {
+      std::mt19937_64 local(seed);
+      std::uint64_t seq = 0;
+      while (!stop.load(std::memory_order_relaxed) && seq < config.items) {
+        queue.produce(local, static_cast<std::uint32_t>(p), seq, config.items);
+      }
+      produced[p] = seq;
+      producers_left.fetch_sub(1);
+
+      // The first producer stops the consumers once every item is enqueued,
+      // so that the single-producer queues keep a single producer. Pills
+      // could overtake items of other producers in a queue that is not FIFO,
+      // so there it also waits for every item to be delivered.
+      if (p == 0) {
+        while (producers_left.load() != 0) {
+          std::this_thread::yield();
+        }
+        if constexpr (!Adapter::fifo) {
+          const auto total = std::accumulate(produced.begin(), produced.end(),
+                                             std::uint64_t{0});
+          while (delivered.load() != total) {
+            std::this_thread::yield();
+          }
+        }
+        while (consumers_left.load() != 0) {
+          if (!queue.try_push_pill()) {
+            std::this_thread::yield();
+          }
+        }
+      }
+    });
+  }
+  for (std::size_t c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c, seed = rng()] {
+      std::mt19937_64 local(seed);
+      while (!checks[c].stopped()) {
+        const auto before = checks[c].received;
+        queue.consume(local, checks[c]);
+        if constexpr (!Adapter::fifo) {
+          delivered.fetch_add(checks[c].received - before);
+        }
+      }
+      consumers_left.fetch_sub(1);
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(config.seconds));
+  stop.store(true);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  const auto hardware = counters.stop();
+
+  // Check that every item was received exactly once
+  std::uint64_t total = 0;
+  std::uint64_t lost = 0;
+  std::uint64_t duplicated = 0;
+  for (std::size_t p = 0; p < producers; ++p) {
+    total += produced[p];
+    for (std::uint64_t seq = 0; seq < config.items; ++seq) {
+      const auto times = seen[p][seq].load(std::memory_order_relaxed);
+      if (seq < produced[p] && times == 0) {
+        ++lost;
+      } else if (times > (seq < produced[p] ? 1 : 0)) {
+        ++duplicated;
+      }
+    }
+  }
+  std::uint64_t received = 0;
+  std::uint64_t reordered = 0;
+  std::uint64_t corrupt = 0;
+  for (const auto& check : checks) {
+    received += check.received;
+    reordered += check.reordered;
+    corrupt += check.corrupt;
+  }
+
+  std::printf("%-24s %2zuP %2zuC capacity %-5zu %10llu items %8.2f Mops/s",
+              name, producers, consumers, queue.capacity(),
+              static_cast<unsigned long long>(total),
+              static_cast<double>(total) / elapsed.count() / 1e6);
+  const char* labels[perf_counters::count] = {"instr", "cache-miss",
+                                              "branch-miss"};
+  for (std::size_t i = 0; i < perf_counters::count; ++i) {
+    if (hardware[i] && total != 0) {
+      std::printf("  %s/item %.2f", labels[i],
+                  static_cast<double>(*hardware[i]) /
+                      static_cast<double>(total));
+    }
+  }
+  std::printf("\n");
+
+  const bool ok = received == total && lost == 0 && duplicated == 0 &&
+                  reordered == 0 && corrupt == 0;
+  if (!ok) {
+    std::printf(
+        "  FAILED: %llu received, %llu lost, %llu duplicated, %llu out of "
+        "order, %llu corrupt\n",
+        static_cast<unsigned long long>(received),
+        static_cast<unsigned long long>(lost),
+        static_cast<unsigned long long>(duplicated),
+        static_cast<unsigned long long>(reordered),
+        static_cast<unsigned long long>(corrupt));
+  }
+  return ok;
+}
+
+/// Queue policy with padded slots and a modulo ring.
+struct padded_traits : zeus::queue_traits {};
+
+/// Queue policy with compact slots and a power-of-two ring.
+struct compact_traits : zeus::queue_traits {
+  static constexpr bool power_of_two = true;
+  using layout = zeus::compact_layout;
+};
+
+/// Queue policy with scrambled slots, parking waiters.
+struct scrambled_traits : zeus::queue_traits {
+  static constexpr bool power_of_two = true;
+  using layout = zeus::scrambled_layout;
+  using wait_strategy = zeus::park_wait<64>;
+};
+
+/// Queue policy backing off while waiting, with sampled sizes.
+struct backoff_traits : zeus::queue_traits {
+  using wait_strategy = zeus::backoff_wait<>;
+  static constexpr std::size_t size_sample_interval = 2;
+};
+}  // namespace
+
+int main() {
+  const settings config;
+  std::printf("seed %llu\n", static_cast<unsigned long long>(config.seed));
+  std::mt19937_64 rng(config.seed);
+
+  bool ok = true;
+  ok &= run<queue_adapter<padded_traits>>("queue/padded", config, rng);
+  ok &= run<queue_adapter<compact_traits>>("queue/compact", config, rng);
+  ok &= run<queue_adapter<scrambled_traits>>("queue/scrambled", config, rng);
+  ok &= run<queue_adapter<backoff_traits>>("queue/backoff", config, rng);
+  ok &= run<sharded_adapter>("sharded_queue", config, rng);
+  ok &= run<spsc_adapter>("spsc_queue", config, rng);
+  ok &= run<unbounded_adapter>("unbounded_queue", config, rng);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "zeus/async_queue.hpp"
+
+/// Coroutine that starts eagerly and destroys itself on completion.
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+/// Executor that defers resumptions until they are run explicitly.
+struct DeferredExecutor {
+  void execute(std::coroutine_handle<> handle) noexcept {
+    pending->push_back(handle);
+  }
+
+  /// Resumes every deferred coroutine.
+  void run() {
+    while (!pending->empty()) {
+      auto handle = pending->front();
+      pending->pop_front();
+      handle.resume();
+    }
+  }
+
+  std::deque<std::coroutine_handle<>>* pending;
+};
+
+/// Pops one item from queue into out.
+template <typename Q>
+DetachedTask pop_one(Q& queue, int& out) {
+  out = co_await queue.async_pop();
+}
+
+/// Pushes count increasing items into queue, then sets done.
+template <typename Q>
+DetachedTask push_many(Q& queue, int count, bool& done) {
+  for (int i = 0; i < count; ++i) {
+    co_await queue.async_push(i);
+  }
+  done = true;
+}
+
+/// Tests that an awaited pop completes immediately when an item is ready.
+TEST(AsyncQueueTest, ReadyPop) {
+  zeus::async_queue<int> queue(4);
+  ASSERT_TRUE(queue.try_push(3));
+  int value = 0;
+  pop_one(queue, value);
+  ASSERT_EQ(value, 3);
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Tests that a consumer suspended on an empty queue is resumed through the
+/// executor with the next item.
+TEST(AsyncQueueTest, SuspendedPop) {
+  std::deque<std::coroutine_handle<>> pending;
+  zeus::async_queue<int, DeferredExecutor> queue(4, DeferredExecutor{&pending});
+
+  int value = 0;
+  pop_one(queue, value);
+  ASSERT_TRUE(pending.empty());
+
+  ASSERT_TRUE(queue.try_push(5));
+  ASSERT_EQ(pending.size(), 1u);
+  ASSERT_EQ(value, 0);
+  queue.try_push(6);
+  DeferredExecutor{&pending}.run();
+  ASSERT_EQ(value, 5);
+  ASSERT_EQ(queue.try_pop(), 6);
+}
+
+/// Tests that a producer suspended on a full queue resumes as consumers free
+/// slots.
+TEST(AsyncQueueTest, SuspendedPush) {
+  zeus::async_queue<int> queue(1);
+  bool done = false;
+  push_many(queue, 3, done);
+  ASSERT_FALSE(done);
+
+  ASSERT_EQ(queue.try_pop(), 0);
+  ASSERT_FALSE(done);
+  ASSERT_EQ(queue.try_pop(), 1);
+  ASSERT_TRUE(done);
+  ASSERT_EQ(queue.try_pop(), 2);
+  ASSERT_FALSE(queue.try_pop().has_value());
+}
+
+/// Sums count items popped from queue into total, then counts down
+/// remaining.
+template <typename Q>
+DetachedTask sum_many(Q& queue,
+                      int count,
+                      std::atomic<long long>& total,
+                      std::atomic_int& remaining) {
+  for (int i = 0; i < count; ++i) {
+    total += co_await queue.async_pop();
+  }
+  --remaining;
+}
+
+/// Tests that coroutines suspended on the queue are resumed by producer
+/// threads without losing items or wake-ups.
+TEST(AsyncQueueTest, ConcurrentProducers) {
+  constexpr int NUM_THREADS = 4;
+  constexpr int NUM_CONSUMERS = 8;
+  constexpr int NUM_OPERATIONS = 1000;
+  zeus::async_queue<int> queue(8);
+  std::atomic<long long> total = 0;
+  std::atomic_int remaining = NUM_CONSUMERS;
+
+  for (int i = 0; i < NUM_CONSUMERS; ++i) {
+    sum_many(queue, NUM_THREADS * NUM_OPERATIONS / NUM_CONSUMERS, total,
+             remaining);
+  }
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    producers.emplace_back([&] {
+      for (int j = 0; j < NUM_OPERATIONS; ++j) {
+        while (!queue.try_push(j)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  ASSERT_EQ(remaining, 0);
+  ASSERT_EQ(total, NUM_THREADS * (NUM_OPERATIONS * (NUM_OPERATIONS - 1LL) / 2));
+  ASSERT_TRUE(queue.empty());
+}
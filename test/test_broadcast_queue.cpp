@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "zeus/broadcast_queue.hpp"
+
+/// Tests that every consumer receives every item and that the producer is
+/// gated on the slowest consumer.
+TEST(BroadcastQueueTest, GatedOnSlowestConsumer) {
+  zeus::broadcast_queue<int> queue(4, 2);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.try_push(i));
+  }
+  ASSERT_FALSE(queue.try_push(4));
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(queue.pop(0), i);
+  }
+  ASSERT_FALSE(queue.try_pop(0).has_value());
+  ASSERT_FALSE(queue.try_push(4));
+
+  ASSERT_EQ(queue.try_pop(1), 0);
+  ASSERT_TRUE(queue.try_push(4));
+  ASSERT_EQ(queue.size(1), 4u);
+  ASSERT_EQ(queue.pop(0), 4);
+  ASSERT_TRUE(queue.empty(0));
+}
+
+/// Tests that concurrent consumers each observe the full sequence in order.
+TEST(BroadcastQueueTest, ConcurrentFanOut) {
+  constexpr int NUM_CONSUMERS = 4;
+  constexpr int NUM_OPERATIONS = 20000;
+  zeus::broadcast_queue<int> queue(64, NUM_CONSUMERS);
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < NUM_CONSUMERS; ++c) {
+    consumers.emplace_back([&, c] {
+      for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        ASSERT_EQ(queue.pop(c), i);
+      }
+    });
+  }
+
+  for (int i = 0; i < NUM_OPERATIONS; ++i) {
+    queue.push(i);
+  }
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+}
+
+/// Item spanning several words, checked for torn reads.
+struct Quote {
+  std::uint64_t sequence;
+  std::uint64_t copies[3];
+};
+
+/// Tests that a lapped consumer of a lossy queue skips to the oldest item
+/// and counts the items it missed.
+TEST(BroadcastQueueTest, LossyOverrun) {
+  zeus::broadcast_queue<int, true> queue(4, 1);
+  for (int i = 0; i < 10; ++i) {
+    queue.push(i);
+  }
+
+  ASSERT_EQ(queue.pop(0), 7);
+  ASSERT_EQ(queue.dropped(0), 7u);
+  ASSERT_EQ(queue.pop(0), 8);
+  ASSERT_EQ(queue.pop(0), 9);
+  ASSERT_FALSE(queue.try_pop(0).has_value());
+}
+
+/// Tests that consumers racing a lossy producer never observe torn items and
+/// account for every item as either read or dropped.
+TEST(BroadcastQueueTest, LossyConcurrent) {
+  constexpr int NUM_CONSUMERS = 2;
+  constexpr std::uint64_t NUM_OPERATIONS = 50000;
+  zeus::broadcast_queue<Quote, true> queue(8, NUM_CONSUMERS);
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < NUM_CONSUMERS; ++c) {
+    consumers.emplace_back([&, c] {
+      std::uint64_t read = 0;
+      std::uint64_t last = 0;
+      while (last != NUM_OPERATIONS) {
+        const Quote quote = queue.pop(c);
+        for (auto copy : quote.copies) {
+          ASSERT_EQ(copy, quote.sequence);
+        }
+        ASSERT_GT(quote.sequence, last);
+        last = quote.sequence;
+        ++read;
+      }
+      ASSERT_EQ(read + queue.dropped(c), NUM_OPERATIONS);
+    });
+  }
+
+  for (std::uint64_t i = 1; i <= NUM_OPERATIONS; ++i) {
+    queue.push(Quote{i, {i, i, i}});
+  }
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zeus/byte_queue.hpp"
+
+/// Returns the bytes of a string.
+static std::span<const std::byte> as_bytes(const std::string& value) {
+  return std::as_bytes(std::span(value.data(), value.size()));
+}
+
+/// Returns the string held by a record.
+static std::string to_string(std::span<const std::byte> record) {
+  return std::string(reinterpret_cast<const char*>(record.data()),
+                     record.size());
+}
+
+/// Tests that records of different lengths are returned in order across
+/// several wrap-arounds of the buffer.
+TEST(ByteQueueTest, VariableLengthWrapAround) {
+  zeus::byte_queue<> queue(64);
+  for (int round = 0; round < 20; ++round) {
+    const std::string first(static_cast<std::size_t>(round % 7), 'a');
+    const std::string second(static_cast<std::size_t>(round % 5 + 9), 'b');
+    ASSERT_TRUE(queue.try_push(as_bytes(first)));
+    queue.push(as_bytes(second));
+
+    ASSERT_EQ(to_string(queue.begin_pop().data()), first);
+    auto reader = queue.try_begin_pop();
+    ASSERT_TRUE(reader.has_value());
+    ASSERT_EQ(to_string(reader->data()), second);
+  }
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.try_begin_pop().has_value());
+}
+
+/// Tests that records are rejected when the buffer is full, and accepted
+/// again once consumers release space.
+TEST(ByteQueueTest, FullBuffer) {
+  zeus::byte_queue<> queue(64);
+  ASSERT_EQ(queue.max_record_size(), 32u);
+
+  const std::string record(32, 'x');
+  ASSERT_TRUE(queue.try_push(as_bytes(record)));
+  ASSERT_TRUE(queue.try_push(as_bytes(record)));
+  ASSERT_FALSE(queue.try_push(as_bytes(record)));
+  ASSERT_EQ(queue.size(), 64u);
+
+  {
+    auto reader = queue.begin_pop();
+    ASSERT_FALSE(queue.try_push(as_bytes(record)));
+  }
+  ASSERT_TRUE(queue.try_push(as_bytes(record)));
+}
+
+/// Tests that records larger than max_record_size() are rejected instead of
+/// waiting forever for space.
+TEST(ByteQueueTest, RejectsOversizeRecords) {
+  zeus::byte_queue<> queue(64);
+  const std::string record(queue.max_record_size() + 1, 'x');
+  ASSERT_FALSE(queue.begin_push(record.size()));
+  ASSERT_FALSE(queue.try_begin_push(record.size()).has_value());
+  ASSERT_FALSE(queue.push(as_bytes(record)));
+  ASSERT_FALSE(queue.try_push(as_bytes(record)));
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Tests that a record written in place is not visible before it commits.
+TEST(ByteQueueTest, InPlaceCommit) {
+  zeus::byte_queue<> queue(128);
+  auto writer = queue.begin_push(5);
+  std::memcpy(writer.data().data(), "hello", 5);
+  ASSERT_FALSE(queue.try_begin_pop().has_value());
+  writer.commit();
+  ASSERT_EQ(to_string(queue.begin_pop().data()), "hello");
+}
+
+/// Queue policy backing off while waiting.
+struct ByteBackoffTraits : zeus::queue_traits {
+  using wait_strategy = zeus::backoff_wait<>;
+};
+
+/// Tests that concurrent producers and consumers exchange every record
+/// intact.
+TEST(ByteQueueTest, ConcurrentAccess) {
+  constexpr int NUM_THREADS = 4;
+  constexpr int NUM_OPERATIONS = 2000;
+  zeus::byte_queue<ByteBackoffTraits> queue(256);
+  std::atomic<long long> total = 0;
+  std::vector<std::thread> producers, consumers;
+
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    producers.emplace_back([&] {
+      for (int j = 0; j < NUM_OPERATIONS; ++j) {
+        // Repeat the value's digits so that torn records are detected
+        const std::string value = std::to_string(j);
+        std::string record;
+        for (int k = 0; k <= j % 4; ++k) {
+          record += value + ",";
+        }
+        queue.push(as_bytes(record));
+      }
+    });
+
+    consumers.emplace_back([&] {
+      for (int j = 0; j < NUM_OPERATIONS; ++j) {
+        auto reader = queue.begin_pop();
+        const auto record = to_string(reader.data());
+        const auto value = record.substr(0, record.find(','));
+        std::string expected;
+        for (int k = 0; k <= std::stoi(value) % 4; ++k) {
+          expected += value + ",";
+        }
+        ASSERT_EQ(record, expected);
+        total += std::stoi(value);
+      }
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  ASSERT_EQ(total, NUM_THREADS * (NUM_OPERATIONS * (NUM_OPERATIONS - 1LL) / 2));
+  ASSERT_TRUE(queue.empty());
+}
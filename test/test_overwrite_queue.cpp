@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "zeus/overwrite_queue.hpp"
+
+/// Tests that a full queue overwrites its oldest items and counts them once
+/// skipped.
+TEST(OverwriteQueueTest, OverwritesOldest) {
+  zeus::overwrite_queue<int> queue(4);
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.try_pop().has_value());
+
+  for (int i = 0; i < 10; ++i) {
+    queue.push(i);
+  }
+  ASSERT_EQ(queue.size(), 4u);
+
+  ASSERT_EQ(queue.dropped(), 0u);
+  ASSERT_EQ(queue.try_pop(), 6);
+  ASSERT_EQ(queue.dropped(), 6u);
+  ASSERT_EQ(queue.pop(), 7);
+  ASSERT_EQ(queue.pop(), 8);
+  ASSERT_EQ(queue.pop(), 9);
+  ASSERT_FALSE(queue.try_pop().has_value());
+  ASSERT_EQ(queue.dropped(), 6u);
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Item whose copies must all match, to detect torn reads.
+struct Snapshot {
+  std::uint32_t producer;
+  std::uint64_t sequence;
+  std::uint64_t copies[3];
+};
+
+/// Tests that consumers racing producers that lap them never observe torn
+/// items, see each producer's items in order, and account for every item as
+/// either read or dropped.
+TEST(OverwriteQueueTest, ConcurrentOverwrite) {
+  constexpr int NUM_THREADS = 2;
+  constexpr std::uint64_t NUM_OPERATIONS = 50000;
+  zeus::overwrite_queue<Snapshot> queue(8);
+  std::atomic_bool done = false;
+  std::atomic_uint64_t read = 0;
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < NUM_THREADS; ++c) {
+    consumers.emplace_back([&] {
+      std::uint64_t last[NUM_THREADS] = {};
+      while (true) {
+        const bool finished = done.load();
+        const auto snapshot = queue.try_pop();
+        if (!snapshot) {
+          if (finished) {
+            break;
+          }
+          std::this_thread::yield();
+          continue;
+        }
+        for (auto copy : snapshot->copies) {
+          ASSERT_EQ(copy, snapshot->sequence);
+        }
+        ASSERT_GT(snapshot->sequence, last[snapshot->producer]);
+        last[snapshot->producer] = snapshot->sequence;
+        read.fetch_add(1);
+      }
+    });
+  }
+
+  std::vector<std::thread> producers;
+  for (std::uint32_t p = 0; p < NUM_THREADS; ++p) {
+    producers.emplace_back([&queue, p] {
+      for (std::uint64_t i = 1; i <= NUM_OPERATIONS; ++i) {
+        queue.push(Snapshot{p, i, {i, i, i}});
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  done.store(true);
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  ASSERT_EQ(read.load() + queue.dropped(), NUM_THREADS * NUM_OPERATIONS);
+}
+
+/// Tests that a consumer blocked on an empty queue is woken by a push.
+TEST(OverwriteQueueTest, BlockingPop) {
+  zeus::overwrite_queue<int> queue(2);
+  std::thread consumer([&queue] { ASSERT_EQ(queue.pop(), 42); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.push(42);
+  consumer.join();
+  ASSERT_TRUE(queue.empty());
+}
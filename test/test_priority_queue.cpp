@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "zeus/priority_queue.hpp"
+
+/// Tests that items are popped from the highest-priority non-empty level and
+/// in FIFO order within a level.
+TEST(PriorityQueueTest, HighestLevelFirst) {
+  zeus::priority_queue<int, 3> queue(4);
+  queue.push(2, 20);
+  queue.push(1, 10);
+  queue.push(2, 21);
+  ASSERT_TRUE(queue.try_push(0, 0));
+  queue.push(1, 11);
+  ASSERT_EQ(queue.size(1), 2);
+
+  for (int expected : {0, 10, 11, 20, 21}) {
+    ASSERT_EQ(queue.pop(), expected);
+  }
+  ASSERT_FALSE(queue.try_pop().has_value());
+  ASSERT_TRUE(queue.empty());
+
+  queue.push(2, 22);
+  ASSERT_EQ(queue.try_pop(), 22);
+}
+
+/// Tests that the starvation guard serves a lower level while a higher level
+/// stays non-empty.
+TEST(PriorityQueueTest, StarvationGuard) {
+  zeus::priority_queue<int, 2, 4> queue(16);
+  queue.push(1, -1);
+  for (int i = 0; i < 16; ++i) {
+    queue.push(0, i);
+  }
+
+  int low_at = -1;
+  for (int i = 0; i < 17; ++i) {
+    if (queue.pop() == -1) {
+      low_at = i;
+    }
+  }
+  ASSERT_GE(low_at, 0);
+  ASSERT_LT(low_at, 8);
+}
+
+/// Tests that every item is popped exactly once under concurrent producers
+/// and consumers spread over all levels.
+TEST(PriorityQueueTest, ConcurrentAccess) {
+  constexpr int NUM_THREADS = 3;
+  constexpr int NUM_OPERATIONS = 10000;
+  zeus::priority_queue<int, 4> queue(32);
+  std::vector<std::atomic_int> seen(NUM_THREADS * NUM_OPERATIONS);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < NUM_THREADS; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        queue.push(static_cast<std::size_t>(i % 4), t * NUM_OPERATIONS + i);
+      }
+    });
+    threads.emplace_back([&] {
+      for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        seen[queue.pop()].fetch_add(1);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& count : seen) {
+    ASSERT_EQ(count.load(), 1);
+  }
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Queue policy parking consumers while waiting.
+struct PriorityParkTraits : zeus::queue_traits {
+  using wait_strategy = zeus::park_wait<>;
+};
+
+/// Tests that consumers parked on an empty queue are woken by pushes to any
+/// level.
+TEST(PriorityQueueTest, WakesParkedConsumers) {
+  constexpr int NUM_CONSUMERS = 2;
+  constexpr int NUM_OPERATIONS = 2000;
+  zeus::priority_queue<int, 4, 0, PriorityParkTraits> queue(4);
+  std::vector<std::atomic_int> taken(NUM_OPERATIONS);
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < NUM_CONSUMERS; ++c) {
+    consumers.emplace_back([&] {
+      for (int i = 0; i < NUM_OPERATIONS / NUM_CONSUMERS; ++i) {
+        taken[queue.pop()].fetch_add(1);
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  for (int i = 0; i < NUM_OPERATIONS; ++i) {
+    if (i % 256 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    queue.push(static_cast<std::size_t>(i) % queue.levels(), i);
+  }
+
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+  for (auto& count : taken) {
+    ASSERT_EQ(count.load(), 1);
+  }
+}
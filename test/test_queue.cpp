@@ -1,7 +1,14 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "zeus/huge_page_allocator.hpp"
 #include "zeus/queue.hpp"
 
 /// Represents a custom object with an integer value.
@@ -110,6 +117,22 @@ TEST_F(QueueTest, TryPop) {
   ASSERT_TRUE(testQueue.empty());
 }
 
+/// Tests that move-only items pass through push, blocking pop and pop into
+/// caller storage.
+TEST(MoveOnlyTest, UniquePtr) {
+  zeus::queue<std::unique_ptr<int>> queue(4);
+  queue.push(std::make_unique<int>(1));
+  queue.emplace(std::make_unique<int>(2));
+  ASSERT_TRUE(queue.try_emplace(std::make_unique<int>(3)));
+
+  ASSERT_EQ(*queue.pop(), 1);
+  auto out = std::make_unique<int>(0);
+  queue.pop(out);
+  ASSERT_EQ(*out, 2);
+  ASSERT_EQ(**queue.try_pop(), 3);
+  ASSERT_TRUE(queue.empty());
+}
+
 /// Tests that the queue's size function accurately reflects the number of
 /// elements it contains.
 TEST_F(QueueTest, Size) {
@@ -210,6 +233,778 @@ TEST_F(QueueTest, CustomObjectQueue) {
   }
 }
 
+/// Power-of-two indexing for dynamic capacities policy.
+struct PowerOfTwoTraits : zeus::queue_traits {
+  static constexpr bool power_of_two = true;
+};
+
+/// Prefetching policy with a distance larger than the test capacity.
+struct PrefetchTraits : zeus::queue_traits {
+  static constexpr std::size_t prefetch_distance = 8;
+};
+
+/// Tests that prefetching slots ahead of the head and tail, including past
+/// the end of the ring, leaves FIFO order intact on every path.
+TEST(PrefetchTest, KeepsOrder) {
+  zeus::queue<int, zeus::dynamic_capacity, PrefetchTraits> queue(6);
+  for (int round = 0; round < 3; ++round) {
+    queue.emplace(0);
+    ASSERT_TRUE(queue.try_emplace(1));
+    const int items[] = {2, 3, 4};
+    queue.push_bulk(std::begin(items), std::end(items));
+    ASSERT_EQ(queue.try_push_bulk(std::begin(items), std::end(items)), 1u);
+
+    ASSERT_EQ(queue.pop(), 0);
+    ASSERT_EQ(queue.try_pop(), 1);
+    int out[4];
+    queue.pop_bulk(out, 2);
+    ASSERT_EQ(queue.try_pop_bulk(out + 2, 4), 2u);
+    ASSERT_EQ(out[0], 2);
+    ASSERT_EQ(out[1], 3);
+    ASSERT_EQ(out[2], 4);
+    ASSERT_EQ(out[3], 2);
+  }
+}
+
+/// Tests that a compile-time capacity queue holds exactly N items and wraps
+/// around correctly.
+TEST(FixedQueueTest, CompileTimeCapacity) {
+  zeus::queue<int, 4> queue;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(queue.try_emplace(round * 4 + i));
+    }
+    ASSERT_FALSE(queue.try_emplace(-1));
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_EQ(queue.pop(), round * 4 + i);
+    }
+    ASSERT_TRUE(queue.empty());
+  }
+}
+
+/// Tests that the power-of-two policy rounds a dynamic capacity up and keeps
+/// FIFO order across several turns.
+TEST(FixedQueueTest, PowerOfTwoCapacity) {
+  zeus::queue<int, zeus::dynamic_capacity, PowerOfTwoTraits> queue(5);
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_TRUE(queue.try_emplace(round * 8 + i));
+    }
+    ASSERT_FALSE(queue.try_emplace(-1));
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_EQ(queue.try_pop(), round * 8 + i);
+    }
+    ASSERT_FALSE(queue.try_pop().has_value());
+  }
+}
+
+/// Compact slot layout policy.
+struct CompactTraits : zeus::queue_traits {
+  using layout = zeus::compact_layout;
+};
+
+/// Scrambled slot layout policy.
+struct ScrambledTraits : zeus::queue_traits {
+  using layout = zeus::scrambled_layout;
+};
+
+/// Tests that the compact layout stops padding slots to a cache line.
+TEST(LayoutTest, CompactSlotSize) {
+  ASSERT_EQ(sizeof(zeus::slot<int>), zeus::hw_inf_size);
+  ASSERT_LE(sizeof(zeus::slot<int, zeus::compact_layout::alignment>), 16u);
+}
+
+/// Trivially copyable payload larger than a machine word.
+struct Quote {
+  double price;
+  std::uint64_t volume;
+  char symbol[8];
+};
+
+/// Tests that slots of trivially destructible items are trivially
+/// destructible, and that trivially copyable items round-trip through the
+/// memcpy path across several turns.
+TEST(LayoutTest, TrivialPayloads) {
+  static_assert(std::is_trivially_destructible_v<zeus::slot<int>>);
+  static_assert(std::is_trivially_destructible_v<zeus::slot<Quote>>);
+  static_assert(
+      !std::is_trivially_destructible_v<zeus::slot<std::unique_ptr<int>>>);
+
+  zeus::queue<Quote> queue(3);
+  for (std::uint64_t i = 0; i < 10; ++i) {
+    const Quote quote{1.5 * static_cast<double>(i), i, "ZEUS"};
+    queue.push(quote);
+    const Quote popped = queue.pop();
+    ASSERT_EQ(popped.price, quote.price);
+    ASSERT_EQ(popped.volume, i);
+    ASSERT_STREQ(popped.symbol, "ZEUS");
+  }
+  queue.push(Quote{});
+}
+
+/// Tests that the index scrambler is a permutation that spreads consecutive
+/// indices over different cache lines.
+TEST(LayoutTest, ScramblerPermutes) {
+  constexpr std::size_t capacity = 64;
+  constexpr std::size_t slot_size = 16;
+  zeus::index_scrambler scramble(capacity, slot_size);
+  std::vector<bool> seen(capacity, false);
+  for (std::size_t i = 0; i < capacity; ++i) {
+    const std::size_t j = scramble(i);
+    ASSERT_LT(j, capacity);
+    ASSERT_FALSE(seen[j]);
+    seen[j] = true;
+  }
+  constexpr std::size_t per_line = zeus::hw_inf_size / slot_size;
+  ASSERT_NE(scramble(0) / per_line, scramble(1) / per_line);
+}
+
+/// Tests FIFO order across several turns for the compact and scrambled
+/// layouts.
+TEST(LayoutTest, PackedLayoutsKeepOrder) {
+  zeus::queue<int, zeus::dynamic_capacity, CompactTraits> compact(6);
+  zeus::queue<int, 16, ScrambledTraits> scrambled;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 16; ++i) {
+      ASSERT_TRUE(scrambled.try_emplace(round * 16 + i));
+    }
+    ASSERT_FALSE(scrambled.try_emplace(-1));
+    for (int i = 0; i < 6; ++i) {
+      compact.push(round * 6 + i);
+    }
+    for (int i = 0; i < 16; ++i) {
+      ASSERT_EQ(scrambled.pop(), round * 16 + i);
+    }
+    for (int i = 0; i < 6; ++i) {
+      ASSERT_EQ(compact.pop(), round * 6 + i);
+    }
+  }
+}
+
+/// Spin-then-park wait strategy policy.
+struct ParkTraits : zeus::queue_traits {
+  using wait_strategy = zeus::park_wait<16>;
+};
+
+/// Exponential backoff wait strategy policy.
+struct BackoffTraits : zeus::queue_traits {
+  using wait_strategy = zeus::backoff_wait<>;
+};
+
+/// Tests that a consumer parked in pop is woken by a later producer.
+TEST(WaitStrategyTest, ParkedConsumerWakes) {
+  zeus::queue<int, zeus::dynamic_capacity, ParkTraits> queue(4);
+  std::thread consumer([&] { ASSERT_EQ(queue.pop(), 42); });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  queue.push(42);
+  consumer.join();
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Tests that blocked producers and consumers make progress with the parking
+/// and backoff strategies.
+TEST(WaitStrategyTest, BlockingExchange) {
+  constexpr int NUM_OPERATIONS = 1000;
+  zeus::queue<int, zeus::dynamic_capacity, ParkTraits> parked(2);
+  zeus::queue<int, zeus::dynamic_capacity, BackoffTraits> backoff(2);
+
+  std::thread producer([&] {
+    for (int i = 0; i < NUM_OPERATIONS; ++i) {
+      parked.push(i);
+      backoff.push(i);
+    }
+  });
+
+  long long parked_sum = 0, backoff_sum = 0;
+  for (int i = 0; i < NUM_OPERATIONS; ++i) {
+    parked_sum += parked.pop();
+    backoff_sum += backoff.pop();
+  }
+  producer.join();
+
+  constexpr long long expected = NUM_OPERATIONS * (NUM_OPERATIONS - 1LL) / 2;
+  ASSERT_EQ(parked_sum, expected);
+  ASSERT_EQ(backoff_sum, expected);
+}
+
+/// Tests that try_push_bulk enqueues the prefix that fits and try_pop_bulk
+/// drains it in order.
+TEST_F(QueueTest, TryBulk) {
+  std::vector<int> input(12);
+  for (int i = 0; i < 12; ++i) {
+    input[i] = i;
+  }
+
+  ASSERT_EQ(testQueue.try_push_bulk(input.begin(), input.end()), 10u);
+  ASSERT_EQ(testQueue.try_push_bulk(input.begin(), input.end()), 0u);
+
+  std::vector<int> output;
+  ASSERT_EQ(testQueue.try_pop_bulk(std::back_inserter(output), 4), 4u);
+  ASSERT_EQ(testQueue.try_pop_bulk(std::back_inserter(output), 20), 6u);
+  ASSERT_EQ(testQueue.try_pop_bulk(std::back_inserter(output), 20), 0u);
+  ASSERT_EQ(output, std::vector<int>(input.begin(), input.begin() + 10));
+  ASSERT_TRUE(testQueue.empty());
+}
+
+/// Tests that blocking bulk operations larger than the capacity exchange every
+/// item between concurrent producers and consumers.
+TEST(BulkTest, ConcurrentBulk) {
+  zeus::queue<int, zeus::dynamic_capacity, BackoffTraits> queue(10);
+  constexpr int NUM_THREADS = 4;
+  constexpr int BATCH = 32;
+  constexpr int NUM_BATCHES = 50;
+  std::vector<std::thread> producers, consumers;
+  std::vector<long long> sums(NUM_THREADS, 0);
+
+  for (int i = 0; i < NUM_THREADS; ++i) {
+    producers.emplace_back([&] {
+      std::vector<int> batch(BATCH);
+      for (int j = 0; j < NUM_BATCHES; ++j) {
+        for (int k = 0; k < BATCH; ++k) {
+          batch[k] = j * BATCH + k;
+        }
+        queue.push_bulk(batch.begin(), batch.end());
+      }
+    });
+
+    consumers.emplace_back([&, i] {
+      std::vector<int> batch(BATCH);
+      for (int j = 0; j < NUM_BATCHES; ++j) {
+        queue.pop_bulk(batch.begin(), BATCH);
+        for (int value : batch) {
+          sums[i] += value;
+        }
+      }
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  constexpr long long per_producer =
+      BATCH * NUM_BATCHES * (BATCH * NUM_BATCHES - 1LL) / 2;
+  long long total = 0;
+  for (long long sum : sums) {
+    total += sum;
+  }
+  ASSERT_EQ(total, per_producer * NUM_THREADS);
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Allocator that counts the slots it hands out.
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  explicit CountingAllocator(std::size_t* live) noexcept : live(live) {}
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>& other) noexcept
+      : live(other.live) {}
+
+  T* allocate(std::size_t n) {
+    *live += n;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* pointer, std::size_t n) noexcept {
+    *live -= n;
+    std::allocator<T>().deallocate(pointer, n);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U>& other) const noexcept {
+    return live == other.live;
+  }
+
+  std::size_t* live;
+};
+
+/// Slot allocation through CountingAllocator.
+struct CountingTraits : zeus::queue_traits {
+  template <typename U>
+  using allocator = CountingAllocator<U>;
+};
+
+/// Slot allocation through zeus::huge_page_allocator.
+struct HugePageTraits : zeus::queue_traits {
+  template <typename U>
+  using allocator = zeus::huge_page_allocator<U>;
+};
+
+/// Tests that the slot array is obtained from and returned to the configured
+/// allocator.
+TEST(AllocatorTest, CustomAllocator) {
+  std::size_t live = 0;
+  {
+    using counting_queue = zeus::queue<int, zeus::dynamic_capacity,
+                                       CountingTraits>;
+    counting_queue queue(8, counting_queue::allocator_type(&live));
+    ASSERT_EQ(live, 9u);
+    queue.push(1);
+    ASSERT_EQ(queue.pop(), 1);
+  }
+  ASSERT_EQ(live, 0u);
+}
+
+/// Tests that a queue backed by the huge page allocator works, falling back to
+/// regular pages when no huge pages are reserved.
+TEST(AllocatorTest, HugePageAllocator) {
+  zeus::huge_page_options options;
+  options.prefault = true;
+  using huge_queue = zeus::queue<int, zeus::dynamic_capacity, HugePageTraits>;
+  huge_queue queue(1 << 12, huge_queue::allocator_type(options));
+  for (int i = 0; i < 1 << 12; ++i) {
+    ASSERT_TRUE(queue.try_push(i));
+  }
+  for (int i = 0; i < 1 << 12; ++i) {
+    ASSERT_EQ(queue.pop(), i);
+  }
+}
+
+/// Slots left unconstructed on zero-filled pages.
+struct LazyTraits : HugePageTraits {
+  static constexpr bool lazy_init = true;
+};
+
+/// Tests that a lazily initialized queue starts with empty slots on first
+/// touch and destroys the items left in it.
+TEST(AllocatorTest, LazyInit) {
+  zeus::huge_page_options options;
+  options.page_size = 0;
+  options.prefault = false;
+  using lazy_queue =
+      zeus::queue<std::unique_ptr<int>, zeus::dynamic_capacity, LazyTraits>;
+  lazy_queue queue(1 << 16, lazy_queue::allocator_type(options));
+
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_TRUE(queue.try_emplace(std::make_unique<int>(i)));
+    }
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_EQ(*queue.pop(), i);
+    }
+  }
+  queue.push(std::make_unique<int>(42));
+}
+
+/// Message written and read in place through reservations.
+struct LargeMessage {
+  std::size_t length = 0;
+  char bytes[1024];
+};
+
+/// Tests that items are filled and read in place through reservations, and
+/// that reservations publish and release their slots when destroyed.
+TEST(ReservationTest, InPlace) {
+  zeus::queue<LargeMessage> queue(2);
+  {
+    auto writer = queue.begin_push();
+    writer->length = 3;
+    std::memcpy(writer->bytes, "abc", 3);
+    ASSERT_FALSE(queue.try_begin_pop().has_value());
+    writer.commit();
+  }
+  {
+    auto writer = queue.try_begin_push();
+    ASSERT_TRUE(writer.has_value());
+    (*writer)->length = 5;
+  }
+  ASSERT_FALSE(queue.try_begin_push().has_value());
+
+  {
+    auto reader = queue.begin_pop();
+    ASSERT_EQ(reader->length, 3u);
+    ASSERT_EQ(std::memcmp(reader->bytes, "abc", 3), 0);
+  }
+  auto reader = queue.try_begin_pop();
+  ASSERT_TRUE(reader.has_value());
+  ASSERT_EQ((*reader)->length, 5u);
+  reader->release();
+  ASSERT_FALSE(queue.try_begin_pop().has_value());
+  ASSERT_TRUE(queue.try_begin_push().has_value());
+}
+
+/// Tests that a popped reservation destroys the item it holds.
+TEST(ReservationTest, ReleaseDestroys) {
+  auto item = std::make_shared<int>(1);
+  zeus::queue<std::shared_ptr<int>> queue(4);
+  queue.begin_push(item);
+  ASSERT_EQ(item.use_count(), 2);
+  {
+    auto reader = queue.begin_pop();
+    ASSERT_EQ(reader->get(), item.get());
+  }
+  ASSERT_EQ(item.use_count(), 1);
+}
+
+/// Statistics collection policy.
+struct StatsTraits : zeus::queue_traits {
+  using stats = zeus::sharded_stats<>;
+};
+
+/// Tests that rejections and the occupancy high-water mark are counted.
+TEST(StatsTest, Rejections) {
+  zeus::queue<int, zeus::dynamic_capacity, StatsTraits> queue(4);
+  ASSERT_FALSE(queue.try_pop().has_value());
+  for (int i = 0; i < 4; ++i) {
+    queue.push(i);
+  }
+  ASSERT_FALSE(queue.try_push(4));
+  const int values[] = {4, 5};
+  ASSERT_EQ(queue.try_push_bulk(std::begin(values), std::end(values)), 0u);
+
+  const auto stats = queue.snapshot();
+  ASSERT_EQ(stats.full_rejections, 2u);
+  ASSERT_EQ(stats.empty_rejections, 1u);
+  ASSERT_EQ(stats.cas_failures, 0u);
+  ASSERT_EQ(stats.waits, 0u);
+  ASSERT_EQ(stats.high_water_mark, 4u);
+}
+
+/// Tests that a blocking pop waiting for a producer is counted as a wait.
+TEST(StatsTest, BlockingWait) {
+  zeus::queue<int, zeus::dynamic_capacity, StatsTraits> queue(4);
+  std::thread consumer([&] { ASSERT_EQ(queue.pop(), 1); });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  queue.push(1);
+  consumer.join();
+
+  const auto stats = queue.snapshot();
+  ASSERT_EQ(stats.waits, 1u);
+  ASSERT_GE(stats.wait_spins, 1u);
+  ASSERT_GE(stats.wait_nanoseconds, 1000000u);
+}
+
+/// Residency tracing policy.
+struct TracingTraits : zeus::queue_traits {
+  using tracing = zeus::residency_histogram<4>;
+};
+
+/// Tests that histogram buckets cover every value once, with limits that
+/// bound each bucket within an eighth of its values.
+TEST(TracingTest, BucketBounds) {
+  using snapshot = zeus::latency_snapshot;
+  for (std::size_t bucket = 0; bucket < snapshot::buckets; ++bucket) {
+    const auto limit = snapshot::bucket_limit(bucket);
+    ASSERT_EQ(snapshot::bucket_of(limit), bucket);
+    if (bucket + 1 < snapshot::buckets) {
+      ASSERT_EQ(snapshot::bucket_of(limit + 1), bucket + 1);
+    }
+  }
+  ASSERT_EQ(snapshot::bucket_of(1000), snapshot::bucket_of(1023));
+  ASSERT_NE(snapshot::bucket_of(1000), snapshot::bucket_of(1024));
+}
+
+/// Tests that the enqueue timestamp fits in the slot padding and that every
+/// dequeue path records a residency.
+TEST(TracingTest, RecordsResidency) {
+  static_assert(sizeof(zeus::slot<int, zeus::hw_inf_size, true>) ==
+                sizeof(zeus::slot<int>));
+
+  zeus::queue<int, zeus::dynamic_capacity, TracingTraits> queue(8);
+  for (int i = 0; i < 6; ++i) {
+    queue.push(i);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+  ASSERT_EQ(queue.pop(), 0);
+  ASSERT_EQ(queue.try_pop(), 1);
+  ASSERT_TRUE(queue.consume_one([](int&) noexcept {}));
+  int out[3];
+  ASSERT_EQ(queue.try_pop_bulk(out, 3), 3u);
+
+  const auto residency = queue.residency();
+  ASSERT_EQ(residency.count(), 6u);
+  ASSERT_GT(residency.percentile(0.0), 0u);
+  ASSERT_GE(residency.percentile(1.0), residency.percentile(0.5));
+}
+
+/// Size sampling policy publishing head and tail every 8 tickets.
+struct SampledTraits : zeus::queue_traits {
+  static constexpr std::size_t size_sample_interval = 8;
+};
+
+/// Policy disabling size sampling.
+struct ExactSizeTraits : zeus::queue_traits {
+  static constexpr std::size_t size_sample_interval = 0;
+};
+
+/// Tests that the sampled size tracks the queue within twice the interval and
+/// stays within capacity.
+TEST(OccupancyTest, ApproxSize) {
+  zeus::queue<int, zeus::dynamic_capacity, SampledTraits> queue(64);
+  ASSERT_EQ(queue.approx_size(), 0u);
+  for (int i = 0; i < 50; ++i) {
+    queue.push(i);
+  }
+  ASSERT_GE(queue.approx_size(), 50u - 16u);
+  ASSERT_LE(queue.approx_size(), 50u);
+
+  int out[40];
+  ASSERT_EQ(queue.try_pop_bulk(out, 40), 40u);
+  ASSERT_LE(queue.approx_size(), 10u + 16u);
+  while (queue.try_pop()) {
+  }
+  ASSERT_LE(queue.approx_size(), 16u);
+  ASSERT_LE(queue.approx_size(), queue.capacity());
+
+  zeus::queue<int, zeus::dynamic_capacity, ExactSizeTraits> exact(4);
+  exact.push(1);
+  ASSERT_EQ(exact.approx_size(), 1u);
+}
+
+/// Tests the full and empty hints at both ends of the queue.
+TEST(OccupancyTest, FullAndEmptyHints) {
+  zeus::queue<int> queue(2);
+  ASSERT_TRUE(queue.was_empty());
+  ASSERT_FALSE(queue.was_full());
+  queue.push(1);
+  ASSERT_FALSE(queue.was_empty());
+  ASSERT_FALSE(queue.was_full());
+  queue.push(2);
+  ASSERT_TRUE(queue.was_full());
+  ASSERT_EQ(queue.pop(), 1);
+  ASSERT_FALSE(queue.was_full());
+  ASSERT_EQ(queue.pop(), 2);
+  ASSERT_TRUE(queue.was_empty());
+}
+
+/// Tests that a closed queue rejects producers and drains to an empty optional.
+TEST(CloseTest, RejectsAndDrains) {
+  zeus::queue<int> queue(4);
+  queue.push(1);
+  ASSERT_TRUE(queue.try_push(2));
+  ASSERT_FALSE(queue.closed());
+
+  queue.close();
+  queue.close();
+  ASSERT_TRUE(queue.closed());
+  ASSERT_FALSE(queue.push(3));
+  ASSERT_FALSE(queue.try_push(3));
+  ASSERT_FALSE(queue.begin_push(3));
+  ASSERT_EQ(queue.size(), 2);
+
+  ASSERT_EQ(queue.wait_pop(), 1);
+  ASSERT_EQ(queue.try_pop(), 2);
+  ASSERT_FALSE(queue.try_pop().has_value());
+  ASSERT_FALSE(queue.wait_pop().has_value());
+}
+
+/// Tests that close() wakes parked consumers once the items enqueued before it
+/// are drained, with each item removed exactly once.
+TEST(CloseTest, WakesParkedConsumers) {
+  constexpr int NUM_CONSUMERS = 4;
+  constexpr int NUM_OPERATIONS = 10000;
+  zeus::queue<int, zeus::dynamic_capacity, ParkTraits> queue(8);
+  std::vector<std::atomic_int> taken(NUM_OPERATIONS);
+
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < NUM_CONSUMERS; ++i) {
+    consumers.emplace_back([&] {
+      while (auto value = queue.wait_pop()) {
+        taken[*value].fetch_add(1);
+      }
+    });
+  }
+
+  for (int i = 0; i < NUM_OPERATIONS; ++i) {
+    ASSERT_TRUE(queue.push(i));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  queue.close();
+
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+  for (auto& count : taken) {
+    ASSERT_EQ(count.load(), 1);
+  }
+}
+
+/// Tests that timed pops return an empty optional at once on a closed queue,
+/// whether it was never used or has been drained.
+TEST(CloseTest, TimedPopObservesClose) {
+  using namespace std::chrono_literals;
+  zeus::queue<int> unused(4);
+  unused.close();
+  ASSERT_FALSE(unused.try_pop_for(10s).has_value());
+  ASSERT_FALSE(
+      unused.try_pop_until(std::chrono::steady_clock::now() + 10s)
+          .has_value());
+
+  // Wrap around the ring so that the drained slots are on their second turn
+  zeus::queue<int, zeus::dynamic_capacity, ParkTraits> drained(4);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(drained.try_push(i));
+  }
+  ASSERT_EQ(drained.try_pop_for(10s), 0);
+  ASSERT_EQ(drained.try_pop_for(10s), 1);
+  ASSERT_TRUE(drained.try_push(4));
+  ASSERT_TRUE(drained.try_push(5));
+  drained.close();
+  for (int i = 2; i < 6; ++i) {
+    ASSERT_EQ(drained.try_pop_for(10s), i);
+  }
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_FALSE(drained.try_pop_for(10s).has_value());
+  ASSERT_FALSE(
+      drained.try_pop_until(std::chrono::steady_clock::now() + 10s)
+          .has_value());
+  ASSERT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+/// Tests that pop(T&) returns false once the queue is closed and drained,
+/// including for a consumer already blocked in it.
+TEST(CloseTest, PopIntoObservesClose) {
+  zeus::queue<int, zeus::dynamic_capacity, ParkTraits> queue(4);
+  queue.push(1);
+  int value = 0;
+  ASSERT_TRUE(queue.pop(value));
+  ASSERT_EQ(value, 1);
+
+  std::thread consumer([&queue] {
+    int out = 0;
+    ASSERT_FALSE(queue.pop(out));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue.close();
+  consumer.join();
+  ASSERT_FALSE(queue.pop(value));
+}
+
+/// Tests that consume_one and consume_all invoke the callback on each item in
+/// order and destroy it afterwards.
+TEST(ConsumeTest, InPlaceCallbacks) {
+  zeus::queue<std::unique_ptr<int>> queue(8);
+  ASSERT_FALSE(queue.consume_one([](std::unique_ptr<int>&) noexcept {}));
+
+  for (int i = 0; i < 6; ++i) {
+    queue.push(std::make_unique<int>(i));
+  }
+
+  int seen = -1;
+  ASSERT_TRUE(queue.consume_one(
+      [&seen](std::unique_ptr<int>& item) noexcept { seen = *item; }));
+  ASSERT_EQ(seen, 0);
+
+  std::vector<int> values;
+  auto collect = [&values](std::unique_ptr<int>& item) noexcept {
+    values.push_back(*item);
+  };
+  ASSERT_EQ(queue.consume_all(collect, 3), 3u);
+  ASSERT_EQ(values, (std::vector<int>{1, 2, 3}));
+  ASSERT_EQ(queue.consume_all(collect), 2u);
+  ASSERT_EQ(values, (std::vector<int>{1, 2, 3, 4, 5}));
+  ASSERT_EQ(queue.consume_all(collect), 0u);
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Tests that concurrent consume_all calls consume every item exactly once.
+TEST(ConsumeTest, ConcurrentConsumeAll) {
+  constexpr int NUM_CONSUMERS = 3;
+  constexpr int NUM_OPERATIONS = 20000;
+  zeus::queue<int> queue(64);
+  std::vector<std::atomic_int> taken(NUM_OPERATIONS);
+  std::atomic_int remaining = NUM_OPERATIONS;
+
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < NUM_CONSUMERS; ++i) {
+    consumers.emplace_back([&] {
+      while (remaining.load() > 0) {
+        const auto consumed = queue.consume_all(
+            [&taken](int& value) noexcept { taken[value].fetch_add(1); }, 16);
+        remaining.fetch_sub(static_cast<int>(consumed));
+      }
+    });
+  }
+
+  for (int i = 0; i < NUM_OPERATIONS; ++i) {
+    queue.push(i);
+  }
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+  for (auto& count : taken) {
+    ASSERT_EQ(count.load(), 1);
+  }
+}
+
+/// Tests that the detected topology is consistent with the running machine.
+TEST(TopologyTest, Detects) {
+  const auto topology = zeus::detect_topology();
+  ASSERT_GE(topology.cpus, 1u);
+  ASSERT_GE(topology.numa_nodes, 1u);
+  ASSERT_EQ(topology.interference_size, zeus::hw_inf_size);
+  ASSERT_FALSE(zeus::numa_node_cpus(zeus::numa_nodes().front()).empty());
+  ASSERT_GE(zeus::current_numa_node(), -1);
+}
+
+/// Tests that a queue and its slot array can both be placed on the NUMA node
+/// of the constructing thread.
+TEST(AllocatorTest, LocalNodePlacement) {
+  zeus::huge_page_options options;
+  options.page_size = 0;
+  options.numa_node = zeus::local_numa_node;
+  using huge_queue = zeus::queue<int, zeus::dynamic_capacity, HugePageTraits>;
+  auto queue = zeus::make_placed<huge_queue>(
+      options, 64, huge_queue::allocator_type(options));
+  queue->push(7);
+  ASSERT_EQ(queue->pop(), 7);
+}
+
+/// Tests that placing a control block smaller than a huge page uses regular
+/// pages, so that it succeeds even without reserved huge pages and with the
+/// fallback disabled.
+TEST(AllocatorTest, SmallPlacementUsesRegularPages) {
+  zeus::huge_page_options options;
+  options.fallback = false;
+  auto counter = zeus::make_placed<std::atomic_size_t>(options, 3u);
+  ASSERT_EQ(counter->load(), 3u);
+}
+
+/// Tests that timed operations give up after their timeout and leave no
+/// claimed ticket behind, for every wait strategy.
+template <typename Traits>
+void check_timeouts() {
+  using namespace std::chrono_literals;
+  zeus::queue<int, zeus::dynamic_capacity, Traits> queue(2);
+
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_FALSE(queue.try_pop_for(2ms).has_value());
+  ASSERT_GE(std::chrono::steady_clock::now() - start, 2ms);
+
+  ASSERT_TRUE(queue.try_push_for(1, 1ms));
+  ASSERT_TRUE(queue.try_push_until(2, std::chrono::steady_clock::now()));
+  ASSERT_FALSE(queue.try_push_for(3, 2ms));
+  ASSERT_EQ(queue.size(), 2);
+
+  ASSERT_EQ(queue.try_pop_for(1ms), 1);
+  ASSERT_EQ(queue.pop(), 2);
+  ASSERT_FALSE(queue.try_pop_until(std::chrono::steady_clock::now()));
+  ASSERT_EQ(queue.size(), 0);
+
+  // A consumer waiting with a deadline receives an item pushed later
+  std::thread consumer([&] { ASSERT_EQ(queue.try_pop_for(10s), 4); });
+  std::this_thread::sleep_for(5ms);
+  queue.push(4);
+  consumer.join();
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(TimedTest, SpinTimeouts) { check_timeouts<zeus::queue_traits>(); }
+
+TEST(TimedTest, BackoffTimeouts) { check_timeouts<BackoffTraits>(); }
+
+TEST(TimedTest, ParkTimeouts) { check_timeouts<ParkTraits>(); }
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
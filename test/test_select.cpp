@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+
+#include "zeus/queue.hpp"
+#include "zeus/select.hpp"
+
+/// Queue policy attaching the queues to a set, parking while waiting.
+struct SelectTraits : zeus::queue_traits {
+  using wait_strategy = zeus::select_wait<zeus::park_wait<>>;
+};
+
+using select_queue = zeus::queue<int, zeus::dynamic_capacity, SelectTraits>;
+
+/// Tests that items are taken from every queue, round-robin, along with the
+/// index of their queue.
+TEST(SelectTest, RoundRobin) {
+  select_queue first(8);
+  select_queue second(8);
+  zeus::queue_set<select_queue> set({&first, &second});
+  ASSERT_EQ(set.size(), 2u);
+  ASSERT_FALSE(set.try_pop().has_value());
+
+  first.push(1);
+  first.push(2);
+  second.push(10);
+
+  auto item = set.try_pop();
+  ASSERT_TRUE(item.has_value());
+  ASSERT_EQ(item->index, 0u);
+  ASSERT_EQ(item->value, 1);
+  item = set.try_pop();
+  ASSERT_EQ(item->index, 1u);
+  ASSERT_EQ(item->value, 10);
+  ASSERT_EQ(set.pop().value, 2);
+  ASSERT_FALSE(set.try_pop_for(std::chrono::milliseconds(1)).has_value());
+}
+
+/// Tests that a consumer parked on the set is woken by a push to any queue.
+TEST(SelectTest, WakesParkedConsumer) {
+  constexpr int NUM_OPERATIONS = 2000;
+  select_queue queues[4] = {select_queue(4), select_queue(4), select_queue(4),
+                            select_queue(4)};
+  zeus::queue_set<select_queue> set(
+      {&queues[0], &queues[1], &queues[2], &queues[3]});
+  std::vector<std::atomic_int> taken(4 * NUM_OPERATIONS);
+
+  std::thread consumer([&set, &taken] {
+    for (int i = 0; i < 4 * NUM_OPERATIONS; ++i) {
+      const auto item = set.pop();
+      ASSERT_EQ(static_cast<int>(item.index), item.value / NUM_OPERATIONS);
+      taken[item.value].fetch_add(1);
+    }
+  });
+  std::vector<std::thread> producers;
+  for (int q = 0; q < 4; ++q) {
+    producers.emplace_back([&queues, q] {
+      for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        if (i % 256 == 0) {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        queues[q].push(q * NUM_OPERATIONS + i);
+      }
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  consumer.join();
+  for (auto& count : taken) {
+    ASSERT_EQ(count.load(), 1);
+  }
+}
+
+/// Tests that the eventfd becomes readable once a push follows arm().
+TEST(SelectTest, EventFd) {
+  select_queue first(4);
+  select_queue second(4);
+  zeus::queue_set<select_queue> set({&first, &second}, true);
+  ASSERT_GE(set.native_handle(), 0);
+
+  pollfd events{set.native_handle(), POLLIN, 0};
+  ASSERT_TRUE(set.arm());
+  ASSERT_EQ(poll(&events, 1, 0), 0);
+
+  second.push(7);
+  ASSERT_EQ(poll(&events, 1, 1000), 1);
+  ASSERT_FALSE(set.arm());
+  ASSERT_EQ(set.try_pop()->value, 7);
+  ASSERT_TRUE(set.arm());
+  ASSERT_EQ(poll(&events, 1, 0), 0);
+}
+
+/// Tests that a consumer in a timed pop is woken by a push before its
+/// deadline.
+TEST(SelectTest, WakesTimedConsumer) {
+  select_queue first(4);
+  select_queue second(4);
+  zeus::queue_set<select_queue> set({&first, &second});
+
+  std::thread producer([&second] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    second.push(3);
+  });
+  const auto start = std::chrono::steady_clock::now();
+  const auto item = set.try_pop_for(std::chrono::seconds(10));
+  producer.join();
+  ASSERT_TRUE(item.has_value());
+  ASSERT_EQ(item->index, 1u);
+  ASSERT_EQ(item->value, 3);
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
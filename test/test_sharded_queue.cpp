@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "zeus/sharded_queue.hpp"
+
+/// Tests that a single thread dequeues its own items in FIFO order and that
+/// each lane fills up independently.
+TEST(ShardedQueueTest, SingleThreadFifo) {
+  zeus::sharded_queue<int> queue(4, 8);
+  ASSERT_EQ(queue.lanes(), 4u);
+  ASSERT_EQ(queue.capacity(), 32u);
+
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(queue.try_push(i));
+  }
+  ASSERT_FALSE(queue.try_push(8));
+  ASSERT_TRUE(queue.try_push_to((queue.home_lane() + 1) % 4, 100));
+  ASSERT_EQ(queue.size(), 9);
+
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_EQ(queue.pop(), i);
+  }
+  ASSERT_EQ(queue.try_pop(), 100);
+  ASSERT_FALSE(queue.try_pop().has_value());
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Item tagged with its producer and per-producer sequence number.
+struct Tagged {
+  int producer;
+  int sequence;
+};
+
+/// Tests that every item is dequeued exactly once and that each consumer sees
+/// the items of every producer in the order they were enqueued.
+TEST(ShardedQueueTest, PerProducerFifo) {
+  constexpr int NUM_PRODUCERS = 4;
+  constexpr int NUM_CONSUMERS = 4;
+  constexpr int NUM_OPERATIONS = 10000;
+  zeus::sharded_queue<Tagged> queue(3, 64);
+  std::vector<std::atomic_int> seen(NUM_PRODUCERS * NUM_OPERATIONS);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < NUM_PRODUCERS; ++p) {
+    threads.emplace_back([&, p] {
+      for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        queue.push(Tagged{p, i});
+      }
+    });
+  }
+  for (int c = 0; c < NUM_CONSUMERS; ++c) {
+    threads.emplace_back([&] {
+      std::vector<int> last(NUM_PRODUCERS, -1);
+      for (int i = 0; i < NUM_OPERATIONS * NUM_PRODUCERS / NUM_CONSUMERS;
+           ++i) {
+        const auto [producer, sequence] = queue.pop();
+        ASSERT_GT(sequence, last[producer]);
+        last[producer] = sequence;
+        seen[producer * NUM_OPERATIONS + sequence].fetch_add(1);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& count : seen) {
+    ASSERT_EQ(count.load(), 1);
+  }
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Tests that a queue without lanes is rejected and that threads get
+/// consecutive home lanes, the same in every queue with as many lanes.
+TEST(ShardedQueueTest, HomeLanes) {
+  ASSERT_THROW(zeus::sharded_queue<int>(0, 8), std::invalid_argument);
+
+  zeus::sharded_queue<int> first(2, 4);
+  zeus::sharded_queue<int> second(2, 4);
+  std::size_t lanes[2];
+  for (auto& lane : lanes) {
+    std::thread([&] {
+      lane = first.home_lane();
+      ASSERT_EQ(second.home_lane(), lane);
+      ASSERT_EQ(first.home_lane(), lane);
+    }).join();
+  }
+  ASSERT_EQ(lanes[1], (lanes[0] + 1) % 2);
+}
+
+/// Queue policy parking consumers while waiting.
+struct ShardedParkTraits : zeus::queue_traits {
+  using wait_strategy = zeus::park_wait<>;
+};
+
+/// Tests that consumers parked on an empty queue are woken by pushes to any
+/// lane.
+TEST(ShardedQueueTest, WakesParkedConsumers) {
+  constexpr int NUM_CONSUMERS = 2;
+  constexpr int NUM_OPERATIONS = 2000;
+  zeus::sharded_queue<int, ShardedParkTraits> queue(4, 4);
+  std::vector<std::atomic_int> taken(NUM_OPERATIONS);
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < NUM_CONSUMERS; ++c) {
+    consumers.emplace_back([&] {
+      for (int i = 0; i < NUM_OPERATIONS / NUM_CONSUMERS; ++i) {
+        taken[queue.pop()].fetch_add(1);
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  for (int i = 0; i < NUM_OPERATIONS; ++i) {
+    if (i % 256 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    queue.push_to(static_cast<std::size_t>(i) % queue.lanes(), i);
+  }
+
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+  for (auto& count : taken) {
+    ASSERT_EQ(count.load(), 1);
+  }
+}
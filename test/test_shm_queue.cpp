@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <string>
+#include <system_error>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "zeus/shm_queue.hpp"
+
+/// Trivially copyable message exchanged between processes.
+struct Message {
+  int id;
+  double value;
+};
+
+/// Tests that two mappings of an anonymous queue observe each other's items
+/// in order across wrap-around.
+TEST(ShmQueueTest, AttachSharesItems) {
+  auto producer = zeus::shm_queue<Message>::create_anonymous(4);
+  auto consumer = zeus::shm_queue<Message>::attach(producer.fd());
+  ASSERT_EQ(consumer.capacity(), 4u);
+
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(producer.try_push(Message{round * 4 + i, 0.5}));
+    }
+    ASSERT_FALSE(producer.try_push(Message{-1, 0.0}));
+    ASSERT_EQ(consumer.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_EQ(consumer.pop().id, round * 4 + i);
+    }
+    ASSERT_FALSE(consumer.try_pop().has_value());
+  }
+}
+
+/// Tests creating, opening and unlinking a named queue.
+TEST(ShmQueueTest, NamedQueue) {
+  const std::string name = "/zeus_test_" + std::to_string(::getpid());
+  {
+    auto created = zeus::shm_queue<int>::create(name, 8);
+    ASSERT_THROW(zeus::shm_queue<int>::create(name, 8), std::system_error);
+
+    auto opened = zeus::shm_queue<int>::open(name);
+    created.push(7);
+    ASSERT_EQ(opened.pop(), 7);
+  }
+  zeus::shm_queue<int>::unlink(name);
+  ASSERT_THROW(zeus::shm_queue<int>::open(name), std::system_error);
+}
+
+/// Tests that attaching with a different item type is rejected.
+TEST(ShmQueueTest, LayoutMismatch) {
+  auto queue = zeus::shm_queue<char>::create_anonymous(4);
+  using large = std::array<char, 256>;
+  ASSERT_THROW(zeus::shm_queue<large>::attach(queue.fd()), std::system_error);
+}
+
+/// Tests that a failed create() removes the name it created, so that the
+/// next create() succeeds.
+TEST(ShmQueueTest, FailedCreateUnlinks) {
+  const std::string name = "/zeus_test_fail_" + std::to_string(::getpid());
+  ASSERT_THROW(zeus::shm_queue<int>::create(name, std::size_t{1} << 56),
+               std::system_error);
+  { auto created = zeus::shm_queue<int>::create(name, 8); }
+  zeus::shm_queue<int>::unlink(name);
+}
+
+/// Tests that a zero capacity is rejected before a name is created.
+TEST(ShmQueueTest, ZeroCapacity) {
+  const std::string name = "/zeus_test_zero_" + std::to_string(::getpid());
+  ASSERT_THROW(zeus::shm_queue<int>::create(name, 0), std::system_error);
+  ASSERT_THROW(zeus::shm_queue<int>::open(name), std::system_error);
+  ASSERT_THROW(zeus::shm_queue<int>::create_anonymous(0), std::system_error);
+}
+
+/// Tests that attaching before the creator published the queue reports a
+/// distinct, retryable error instead of a layout mismatch.
+TEST(ShmQueueTest, NotReady) {
+  const int fd = ::memfd_create("zeus_test", MFD_CLOEXEC);
+  ASSERT_GE(fd, 0);
+  try {
+    zeus::shm_queue<int>::attach(fd);
+    FAIL();
+  } catch (const std::system_error& error) {
+    ASSERT_EQ(error.code(), std::errc::resource_unavailable_try_again);
+  }
+
+  ASSERT_EQ(::ftruncate(fd, 4096), 0);
+  try {
+    zeus::shm_queue<int>::attach(fd);
+    FAIL();
+  } catch (const std::system_error& error) {
+    ASSERT_EQ(error.code(), std::errc::resource_unavailable_try_again);
+  }
+  ::close(fd);
+}
+
+/// Tests that a forked child process and its parent exchange every item
+/// through the shared ring.
+TEST(ShmQueueTest, CrossProcess) {
+  constexpr int NUM_OPERATIONS = 10000;
+  auto requests = zeus::shm_queue<int>::create_anonymous(16);
+  auto replies = zeus::shm_queue<long long>::create_anonymous(1);
+
+  const pid_t child = ::fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    long long sum = 0;
+    for (int i = 0; i < NUM_OPERATIONS; ++i) {
+      sum += requests.pop();
+    }
+    replies.push(sum);
+    ::_exit(0);
+  }
+
+  for (int i = 0; i < NUM_OPERATIONS; ++i) {
+    requests.push(i);
+  }
+  ASSERT_EQ(replies.pop(), NUM_OPERATIONS * (NUM_OPERATIONS - 1LL) / 2);
+
+  int status = 0;
+  ::waitpid(child, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+}
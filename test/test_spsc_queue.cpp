@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+#include "zeus/spsc_queue.hpp"
+
+/// Test fixture for single-producer/single-consumer queue tests.
+class SpscQueueTest : public ::testing::Test {
+ protected:
+  zeus::spsc_queue<int> testQueue{10};
+};
+
+/// Tests that items can be enqueued up to the capacity and overfill is
+/// rejected.
+TEST_F(SpscQueueTest, TryEmplace) {
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(testQueue.try_emplace(i));
+  }
+  ASSERT_FALSE(testQueue.try_emplace(11));
+  ASSERT_EQ(testQueue.size(), 10);
+}
+
+/// Tests that push and pop preserve FIFO order across wrap-around.
+TEST_F(SpscQueueTest, PushPop) {
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 7; ++i) {
+      testQueue.push(round * 7 + i);
+    }
+    for (int i = 0; i < 7; ++i) {
+      ASSERT_EQ(testQueue.pop(), round * 7 + i);
+    }
+  }
+  ASSERT_TRUE(testQueue.empty());
+  ASSERT_FALSE(testQueue.try_pop().has_value());
+}
+
+/// Tests that items left in the queue are destroyed with it.
+TEST_F(SpscQueueTest, DestroysRemainingItems) {
+  auto item = std::make_shared<int>(1);
+  {
+    zeus::spsc_queue<std::shared_ptr<int>> queue(4);
+    queue.push(item);
+    queue.push(item);
+    ASSERT_EQ(item.use_count(), 3);
+  }
+  ASSERT_EQ(item.use_count(), 1);
+}
+
+/// Tests that move-only items pass through push, pop and pop into caller
+/// storage.
+TEST(SpscMoveOnlyTest, UniquePtr) {
+  zeus::spsc_queue<std::unique_ptr<int>> queue(4);
+  queue.push(std::make_unique<int>(1));
+  queue.push(std::make_unique<int>(2));
+
+  ASSERT_EQ(*queue.pop(), 1);
+  std::unique_ptr<int> out;
+  queue.pop(out);
+  ASSERT_EQ(*out, 2);
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Tests that a producer and a consumer thread exchange every item in order.
+TEST_F(SpscQueueTest, ConcurrentAccess) {
+  constexpr int NUM_OPERATIONS = 1000;
+
+  std::thread producer([&] {
+    for (int i = 0; i < NUM_OPERATIONS; ++i) {
+      if (i % 2 == 0) {
+        testQueue.push(i);
+      } else {
+        while (!testQueue.try_push(i)) {
+        }
+      }
+    }
+  });
+
+  for (int i = 0; i < NUM_OPERATIONS; ++i) {
+    if (i % 2 == 0) {
+      ASSERT_EQ(testQueue.pop(), i);
+    } else {
+      auto value = testQueue.try_pop();
+      while (!value) {
+        value = testQueue.try_pop();
+      }
+      ASSERT_EQ(*value, i);
+    }
+  }
+
+  producer.join();
+  ASSERT_TRUE(testQueue.empty());
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "zeus/thread_pool.hpp"
+#include "zeus/work_stealing_deque.hpp"
+
+/// Tests that the owner pops in LIFO order while thieves steal in FIFO order.
+TEST(WorkStealingDequeTest, OwnerAndThiefOrder) {
+  zeus::work_stealing_deque<int, 4> deque;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(deque.try_push(i));
+  }
+  ASSERT_FALSE(deque.try_push(4));
+
+  ASSERT_EQ(deque.try_steal(), 0);
+  ASSERT_EQ(deque.try_pop(), 3);
+  ASSERT_EQ(deque.try_steal(), 1);
+  ASSERT_EQ(deque.try_pop(), 2);
+  ASSERT_FALSE(deque.try_pop().has_value());
+  ASSERT_FALSE(deque.try_steal().has_value());
+  ASSERT_TRUE(deque.empty());
+}
+
+/// Tests that every item is taken exactly once when thieves race the owner.
+TEST(WorkStealingDequeTest, ConcurrentSteal) {
+  constexpr int NUM_THIEVES = 3;
+  constexpr int NUM_OPERATIONS = 20000;
+  zeus::work_stealing_deque<int, 64> deque;
+  std::vector<std::atomic_int> taken(NUM_OPERATIONS);
+  std::atomic_int remaining = NUM_OPERATIONS;
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < NUM_THIEVES; ++i) {
+    thieves.emplace_back([&] {
+      while (remaining.load() > 0) {
+        if (auto value = deque.try_steal()) {
+          taken[*value].fetch_add(1);
+          remaining.fetch_sub(1);
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < NUM_OPERATIONS; ++i) {
+    while (!deque.try_push(i)) {
+      if (auto value = deque.try_pop()) {
+        taken[*value].fetch_add(1);
+        remaining.fetch_sub(1);
+      }
+    }
+  }
+  while (auto value = deque.try_pop()) {
+    taken[*value].fetch_add(1);
+    remaining.fetch_sub(1);
+  }
+
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+  for (auto& count : taken) {
+    ASSERT_EQ(count.load(), 1);
+  }
+}
+
+/// Tests that a task stores small callables inline and large ones on the heap,
+/// destroying both exactly once.
+TEST(TaskTest, InlineAndHeapCallables) {
+  auto counter = std::make_shared<int>(0);
+  {
+    zeus::task small([counter] { ++*counter; });
+    std::array<char, 256> payload{};
+    zeus::task large([counter, payload] { *counter += payload.size(); });
+
+    zeus::task moved(std::move(large));
+    small();
+    moved();
+    ASSERT_FALSE(large);
+    ASSERT_EQ(*counter, 257);
+    ASSERT_EQ(counter.use_count(), 3);
+  }
+  ASSERT_EQ(counter.use_count(), 1);
+}
+
+/// Tests that tasks submitted from outside the pool all run before the pool is
+/// destroyed.
+TEST(ThreadPoolTest, ExternalSubmit) {
+  constexpr int NUM_TASKS = 10000;
+  std::atomic_int count = 0;
+  {
+    zeus::thread_pool pool(4);
+    for (int i = 0; i < NUM_TASKS; ++i) {
+      pool.submit([&count] { count.fetch_add(1); });
+    }
+  }
+  ASSERT_EQ(count.load(), NUM_TASKS);
+}
+
+/// Recursively splits [first, last) into tasks, adding each element to sum.
+void parallel_sum(zeus::thread_pool& pool,
+                  std::atomic_llong& sum,
+                  long long first,
+                  long long last) {
+  if (last - first <= 16) {
+    long long local = 0;
+    for (auto i = first; i < last; ++i) {
+      local += i;
+    }
+    sum.fetch_add(local);
+    return;
+  }
+  const auto middle = first + (last - first) / 2;
+  pool.submit([&pool, &sum, first, middle] {
+    parallel_sum(pool, sum, first, middle);
+  });
+  pool.submit([&pool, &sum, middle, last] {
+    parallel_sum(pool, sum, middle, last);
+  });
+}
+
+/// Tests that tasks spawned by workers are stolen and all complete.
+TEST(ThreadPoolTest, NestedSubmit) {
+  constexpr long long NUM_ITEMS = 1 << 16;
+  std::atomic_llong sum = 0;
+  {
+    zeus::thread_pool pool(4, 16);
+    pool.submit([&] { parallel_sum(pool, sum, 0, NUM_ITEMS); });
+  }
+  ASSERT_EQ(sum.load(), NUM_ITEMS * (NUM_ITEMS - 1) / 2);
+}
+
+/// Tests that workers park when idle and wake for tasks submitted later.
+TEST(ThreadPoolTest, WakesParkedWorkers) {
+  std::atomic_int count = 0;
+  zeus::thread_pool pool(2);
+  for (int round = 0; round < 5; ++round) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    pool.submit([&count] { count.fetch_add(1); });
+    while (count.load() != round + 1) {
+      std::this_thread::yield();
+    }
+  }
+  ASSERT_EQ(pool.size(), 2u);
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "zeus/unbounded_queue.hpp"
+
+/// Tests that items are dequeued in FIFO order across segment boundaries.
+TEST(UnboundedQueueTest, GrowsAcrossSegments) {
+  zeus::unbounded_queue<int, 4> queue;
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.try_pop().has_value());
+
+  for (int i = 0; i < 10; ++i) {
+    queue.push(i);
+  }
+  ASSERT_FALSE(queue.empty());
+  ASSERT_EQ(queue.segments(), 3u);
+
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(queue.pop(), i);
+  }
+  for (int i = 5; i < 10; ++i) {
+    ASSERT_EQ(queue.try_pop(), i);
+  }
+  ASSERT_FALSE(queue.try_pop().has_value());
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Tests that drained segments are reused instead of allocating new ones.
+TEST(UnboundedQueueTest, RecyclesSegments) {
+  zeus::unbounded_queue<int, 8> queue;
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 8; ++i) {
+      queue.push(round * 8 + i);
+    }
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_EQ(queue.pop(), round * 8 + i);
+    }
+  }
+  ASSERT_LE(queue.segments(), 3u);
+}
+
+/// Tests that items left in the queue are destroyed with it.
+TEST(UnboundedQueueTest, DestroysRemainingItems) {
+  auto counter = std::make_shared<int>(0);
+  {
+    zeus::unbounded_queue<std::shared_ptr<int>, 2> queue;
+    for (int i = 0; i < 5; ++i) {
+      queue.push(counter);
+    }
+    ASSERT_NE(queue.pop(), nullptr);
+    ASSERT_EQ(counter.use_count(), 5);
+  }
+  ASSERT_EQ(counter.use_count(), 1);
+}
+
+/// Tests that every item is dequeued exactly once by concurrent producers and
+/// consumers.
+TEST(UnboundedQueueTest, ConcurrentAccess) {
+  constexpr int NUM_THREADS = 3;
+  constexpr int NUM_OPERATIONS = 20000;
+  zeus::unbounded_queue<int, 16> queue;
+  std::vector<std::atomic_int> taken(NUM_THREADS * NUM_OPERATIONS);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < NUM_THREADS; ++t) {
+    threads.emplace_back([&queue, t] {
+      for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        queue.push(t * NUM_OPERATIONS + i);
+      }
+    });
+    threads.emplace_back([&queue, &taken, t] {
+      for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        if (t == 0) {
+          taken[queue.pop()].fetch_add(1);
+        } else {
+          auto value = queue.try_pop();
+          while (!value) {
+            std::this_thread::yield();
+            value = queue.try_pop();
+          }
+          taken[*value].fetch_add(1);
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& count : taken) {
+    ASSERT_EQ(count.load(), 1);
+  }
+  ASSERT_TRUE(queue.empty());
+}
+
+/// Tests that segments recycled while other threads still hold stale
+/// pointers to them are recycled once, by cycling single-slot segments under
+/// concurrent producers and consumers.
+TEST(UnboundedQueueTest, RecyclesUnderContention) {
+  constexpr int NUM_THREADS = 3;
+  constexpr int NUM_OPERATIONS = 20000;
+  zeus::unbounded_queue<int, 1> queue;
+  std::vector<std::atomic_int> taken(NUM_THREADS * NUM_OPERATIONS);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < NUM_THREADS; ++t) {
+    threads.emplace_back([&queue, t] {
+      for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        queue.push(t * NUM_OPERATIONS + i);
+        if (i % 64 == 0) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    threads.emplace_back([&queue, &taken] {
+      std::vector<int> last(NUM_THREADS, -1);
+      for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        auto value = i % 2 == 0 ? std::optional<int>(queue.pop())
+                                : queue.try_pop();
+        while (!value) {
+          std::this_thread::yield();
+          value = queue.try_pop();
+        }
+        ASSERT_GT(*value, last[*value / NUM_OPERATIONS]);
+        last[*value / NUM_OPERATIONS] = *value;
+        taken[*value].fetch_add(1);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& count : taken) {
+    ASSERT_EQ(count.load(), 1);
+  }
+  ASSERT_TRUE(queue.empty());
+  ASSERT_LT(queue.segments(), std::size_t{NUM_THREADS * NUM_OPERATIONS});
+}
+
+/// Queue policy parking idle threads.
+struct UnboundedParkTraits : zeus::queue_traits {
+  using wait_strategy = zeus::park_wait<>;
+};
+
+/// Tests that consumers parked past the end of a segment, waiting for the
+/// next one to be linked, are woken by producers.
+TEST(UnboundedQueueTest, WakesConsumersPastSegmentEnd) {
+  constexpr int NUM_CONSUMERS = 5;
+  zeus::unbounded_queue<int, 2, UnboundedParkTraits> queue;
+  std::vector<std::atomic_int> taken(NUM_CONSUMERS);
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < NUM_CONSUMERS; ++c) {
+    consumers.emplace_back([&] { taken[queue.pop()].fetch_add(1); });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  for (int i = 0; i < NUM_CONSUMERS; ++i) {
+    queue.push(i);
+  }
+
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+  for (auto& count : taken) {
+    ASSERT_EQ(count.load(), 1);
+  }
+}